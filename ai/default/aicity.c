@@ -84,6 +84,26 @@
 #define SPECVEC_TYPE struct impr_type *
 #include "specvec.h"
 
+/* Player level evaluation of one effect of an improvement. Technology and
+ * government requirements depend only on the player, so they are checked
+ * once for all the cities of the player. */
+struct impr_effect_eval {
+  struct effect *peffect;
+  struct requirement *mypreq;   /* Requirement for the improvement itself */
+  bool active;                  /* Player level requirements are met */
+  bool impossible;              /* Player level requirements can't be met */
+  struct tech_vector needed_techs;
+};
+
+/* What adjust_improvement_wants_by_effects() needs that is the same for
+ * all the cities of a player. */
+struct impr_want_context {
+  int nplayers;
+  int turns;                    /* Until the improvement may go obsolete */
+  int neffects;
+  struct impr_effect_eval *effects;
+};
+
 /* Iterate over cities within a certain range around a given city
  * (city_here) that exist within a given city list. */
 #define city_range_iterate(city_here, list, range, city)		\
@@ -159,7 +179,7 @@ void want_techs_for_improvement_effect(struct ai_type *ait,
                                        struct player *pplayer,
                                        const struct city *pcity,
                                        const struct impr_type *pimprove,
-                                       struct tech_vector *needed_techs,
+                                       const struct tech_vector *needed_techs,
                                        adv_want building_want)
 {
   int t;
@@ -1478,6 +1498,117 @@ static adv_want base_want(struct ai_type *ait, struct player *pplayer,
   return final_want;
 }
 
+/**********************************************************************//**
+  Whether the requirement is evaluated the same way for all the cities of
+  a player, both by is_req_active() and by
+  dai_can_requirement_be_met_in_city().
+**************************************************************************/
+static bool is_player_level_req(const struct requirement *preq)
+{
+  return (VUT_ADVANCE == preq->source.kind
+          || VUT_GOVERNMENT == preq->source.kind);
+}
+
+/**********************************************************************//**
+  Prepare the parts of adjust_improvement_wants_by_effects() that do not
+  depend on the city: the player count, how soon the improvement may go
+  obsolete, and the technology and government requirements of each of
+  its effects.
+**************************************************************************/
+static void impr_want_context_init(struct impr_want_context *ctx,
+                                   struct player *pplayer,
+                                   struct impr_type *pimprove)
+{
+  struct universal source = {
+    .kind = VUT_IMPROVEMENT,
+    .value = {.building = pimprove}
+  };
+  struct effect_list *plist = get_req_source_effects(&source);
+  int i = 0;
+
+  ctx->nplayers = normal_player_count();
+
+  /* Remove team members from the equation */
+  players_iterate(aplayer) {
+    if (aplayer->team
+        && aplayer->team == pplayer->team
+        && aplayer != pplayer) {
+      ctx->nplayers--;
+    }
+  } players_iterate_end;
+
+  ctx->turns = 9999;
+  players_iterate(aplayer) {
+    int potential = (aplayer->server.bulbs_last_turn
+                     + city_list_size(aplayer->cities) + 1);
+
+    if (potential > 0) {
+      requirement_vector_iterate(&pimprove->obsolete_by, pobs) {
+        if (pobs->source.kind == VUT_ADVANCE && pobs->present) {
+          ctx->turns = MIN(ctx->turns,
+                           research_goal_bulbs_required(research_get(aplayer),
+                               advance_number(pobs->source.value.advance))
+                           / (potential + 1));
+        }
+      } requirement_vector_iterate_end;
+    }
+  } players_iterate_end;
+
+  ctx->neffects = (NULL != plist ? effect_list_size(plist) : 0);
+  ctx->effects = fc_calloc(MAX(1, ctx->neffects), sizeof(*ctx->effects));
+
+  effect_list_iterate(plist, peffect) {
+    struct impr_effect_eval *eval = &ctx->effects[i++];
+
+    eval->peffect = peffect;
+    eval->mypreq = NULL;
+    eval->active = TRUE;
+    eval->impossible = FALSE;
+    tech_vector_init(&eval->needed_techs);
+
+    requirement_vector_iterate(&peffect->reqs, preq) {
+      if (VUT_IMPROVEMENT == preq->source.kind
+          && preq->source.value.building == pimprove) {
+        eval->mypreq = preq;
+        continue;
+      }
+      if (!is_player_level_req(preq)) {
+        continue;
+      }
+      if (!is_req_active(pplayer, NULL, NULL, pimprove, NULL, NULL, NULL,
+                         NULL, NULL, NULL, preq, RPT_POSSIBLE)) {
+        eval->active = FALSE;
+        if (VUT_ADVANCE == preq->source.kind && preq->present) {
+          /* This missing requirement is a missing tech requirement.
+           * This will be for some additional effect
+           * (For example, in the default ruleset, Mysticism increases
+           * the effect of Temples). */
+          tech_vector_append(&eval->needed_techs,
+                             preq->source.value.advance);
+        } else if (!dai_can_requirement_be_met_in_city(preq, pplayer,
+                                                       NULL)) {
+          eval->impossible = TRUE;
+        }
+      }
+    } requirement_vector_iterate_end;
+  } effect_list_iterate_end;
+}
+
+/**********************************************************************//**
+  Free the data of an improvement want context.
+**************************************************************************/
+static void impr_want_context_free(struct impr_want_context *ctx)
+{
+  int i;
+
+  for (i = 0; i < ctx->neffects; i++) {
+    tech_vector_free(&ctx->effects[i].needed_techs);
+  }
+  free(ctx->effects);
+  ctx->effects = NULL;
+  ctx->neffects = 0;
+}
+
 /**********************************************************************//**
   Calculate effects of possible improvements and extra effects of existing
   improvements. Consequently adjust the desirability of those improvements
@@ -1511,31 +1642,18 @@ static void adjust_improvement_wants_by_effects(struct ai_type *ait,
                                                 struct player *pplayer,
                                                 struct city *pcity,
                                                 struct impr_type *pimprove,
-                                                const bool already)
+                                                const bool already,
+                                                const struct impr_want_context *ctx)
 {
   adv_want v = 0;
   int cities[REQ_RANGE_COUNT];
-  int nplayers = normal_player_count();
   struct adv_data *ai = adv_data_get(pplayer, NULL);
   bool capital = is_capital(pcity);
   bool can_build = TRUE;
   struct government *gov = government_of_player(pplayer);
-  struct universal source = {
-    .kind = VUT_IMPROVEMENT,
-    .value = {.building = pimprove}
-  };
   const bool is_coinage = improvement_has_flag(pimprove, IF_GOLD);
-  int turns = 9999;
   int place = tile_continent(pcity->tile);
-
-  /* Remove team members from the equation */
-  players_iterate(aplayer) {
-    if (aplayer->team
-        && aplayer->team == pplayer->team
-        && aplayer != pplayer) {
-      nplayers--;
-    }
-  } players_iterate_end;
+  int i;
 
   if (is_coinage) {
     /* Since coinage contains some entirely spurious ruleset values,
@@ -1583,61 +1701,41 @@ static void adjust_improvement_wants_by_effects(struct ai_type *ait,
   /* Invalid building range */
   cities[REQ_RANGE_ADJACENT] = cities[REQ_RANGE_CADJACENT] = 0;
 
-  players_iterate(aplayer) {
-    int potential = (aplayer->server.bulbs_last_turn
-                     + city_list_size(aplayer->cities) + 1);
+  for (i = 0; i < ctx->neffects; i++) {
+    const struct impr_effect_eval *eval = &ctx->effects[i];
+    struct requirement *mypreq = eval->mypreq;
+    bool active = eval->active;
+    int n_needed_techs = tech_vector_size(&eval->needed_techs);
+    bool present = (NULL == mypreq || mypreq->present);
+    bool impossible_to_get = eval->impossible;
 
-    if (potential > 0) {
-      requirement_vector_iterate(&pimprove->obsolete_by, pobs) {
-        if (pobs->source.kind == VUT_ADVANCE && pobs->present) {
-          turns = MIN(turns,
-                      research_goal_bulbs_required(research_get(aplayer),
-                          advance_number(pobs->source.value.advance))
-                      / (potential + 1));
-        }
-      } requirement_vector_iterate_end;
+    if (impossible_to_get) {
+      continue;
     }
-  } players_iterate_end;
 
-  effect_list_iterate(get_req_source_effects(&source), peffect) {
-    struct requirement *mypreq = NULL;
-    bool active = TRUE;
-    int n_needed_techs = 0;
-    struct tech_vector needed_techs;
-    bool present = TRUE;
-    bool impossible_to_get = FALSE;
-
-    tech_vector_init(&needed_techs);
-
-    requirement_vector_iterate(&peffect->reqs, preq) {
+    requirement_vector_iterate(&eval->peffect->reqs, preq) {
       /* Check if all the requirements for the currently evaluated effect
-       * are met, except for having the building that we are evaluating. */
-      if (VUT_IMPROVEMENT == preq->source.kind
-	  && preq->source.value.building == pimprove) {
-	mypreq = preq;
-        present = preq->present;
+       * are met, except for having the building that we are evaluating.
+       * Player level requirements were checked by
+       * impr_want_context_init(). */
+      if ((VUT_IMPROVEMENT == preq->source.kind
+           && preq->source.value.building == pimprove)
+          || is_player_level_req(preq)) {
         continue;
       }
       if (!is_req_active(pplayer, NULL, pcity, pimprove, NULL, NULL, NULL,
                          NULL, NULL, NULL, preq, RPT_POSSIBLE)) {
 	active = FALSE;
-	if (VUT_ADVANCE == preq->source.kind && preq->present) {
-          /* This missing requirement is a missing tech requirement.
-           * This will be for some additional effect
-           * (For example, in the default ruleset, Mysticism increases
-           * the effect of Temples). */
-          tech_vector_append(&needed_techs, preq->source.value.advance);
-        } else if (!dai_can_requirement_be_met_in_city(preq, pplayer, pcity)) {
+        if (!dai_can_requirement_be_met_in_city(preq, pplayer, pcity)) {
           impossible_to_get = TRUE;
         }
       }
     } requirement_vector_iterate_end;
 
-    n_needed_techs = tech_vector_size(&needed_techs);
     if ((active || n_needed_techs) && !impossible_to_get) {
       adv_want v1 = dai_effect_value(pplayer, gov, ai, pcity, capital, 
-                                     turns, peffect, cities[mypreq->range],
-                                     nplayers);
+                                     ctx->turns, eval->peffect,
+                                     cities[mypreq->range], ctx->nplayers);
       /* v1 could be negative (the effect could be undesirable),
        * although it is usually positive.
        * For example, in the default ruleset, Communism decreases the
@@ -1666,12 +1764,10 @@ static void adjust_improvement_wants_by_effects(struct ai_type *ait,
         const adv_want dv = v1 * a / (4 * n_needed_techs);
 
         want_techs_for_improvement_effect(ait, pplayer, pcity, pimprove,
-                                          &needed_techs, dv);
+                                          &eval->needed_techs, dv);
       }
     }
-
-    tech_vector_free(&needed_techs);
-  } effect_list_iterate_end;
+  }
 
   /* Can the city be the target of an action? */
   action_iterate (act_id) {
@@ -1888,6 +1984,9 @@ void dai_build_adv_adjust(struct ai_type *ait, struct player *pplayer,
     /* Handle coinage specially because you can never complete coinage */
     if (is_coinage
         || can_player_build_improvement_later(pplayer, pimprove)) {
+      struct impr_want_context ctx;
+      bool ctx_ready = FALSE;
+
       city_list_iterate(pplayer->cities, pcity) {
         struct ai_city *city_data = def_ai_city_data(pcity, ait);
 
@@ -1902,8 +2001,12 @@ void dai_build_adv_adjust(struct ai_type *ait, struct player *pplayer,
           const bool already = city_has_building(pcity, pimprove);
           int idx = improvement_index(pimprove);
 
+          if (!ctx_ready) {
+            impr_want_context_init(&ctx, pplayer, pimprove);
+            ctx_ready = TRUE;
+          }
           adjust_improvement_wants_by_effects(ait, pplayer, pcity,
-                                              pimprove, already);
+                                              pimprove, already, &ctx);
 
           fc_assert(!(already
                       && 0 < pcity->server.adv->building_want[idx]));
@@ -1931,6 +2034,10 @@ void dai_build_adv_adjust(struct ai_type *ait, struct player *pplayer,
         }
         /* else wait until a later turn */
       } city_list_iterate_end;
+
+      if (ctx_ready) {
+        impr_want_context_free(&ctx);
+      }
     } else {
       /* An impossible improvement */
       city_list_iterate(pplayer->cities, pcity) {
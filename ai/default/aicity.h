@@ -85,7 +85,7 @@ void want_techs_for_improvement_effect(struct ai_type *ait,
                                        struct player *pplayer,
                                        const struct city *pcity,
                                        const struct impr_type *pimprove,
-                                       struct tech_vector *needed_techs,
+                                       const struct tech_vector *needed_techs,
                                        adv_want building_want);
 
 void dont_want_tech_obsoleting_impr(struct ai_type *ait,
@@ -142,6 +142,9 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
     }
     /* Iterate over adjacent tile to find good victim */
     adjc_iterate(&(wld.map), ptile, target) {
+      struct unit *pdef;
+      double chance;
+
       if (unit_list_size(target->units) == 0
           || !can_unit_attack_tile(punit, target)
           || is_ocean_tile(target)
@@ -149,6 +152,7 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
               && !map_is_known_and_seen(target, pplayer, V_MAIN))) {
         continue;
       }
+      pdef = get_defender_with_chance(punit, target, &chance);
       val = 0;
       if (is_stack_vulnerable(target)) {
         unit_list_iterate(target->units, victim) {
@@ -159,9 +163,9 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
           }
         } unit_list_iterate_end;
       } else {
-        val += get_defender(punit, target)->hp * 100;
+        val += pdef->hp * 100;
       }
-      val *= unit_win_chance(punit, get_defender(punit, target));
+      val *= chance;
       val += pterrain->defense_bonus / 10;
       val -= punit->hp * 100;
       
@@ -45,6 +45,8 @@
 #define SPECENUM_VALUE1NAME "TurnDone"
 #define SPECENUM_VALUE2 TEXAI_BUILD_CHOICE
 #define SPECENUM_VALUE2NAME "BuildChoice"
+#define SPECENUM_VALUE3 TEXAI_REQ_DANGER
+#define SPECENUM_VALUE3NAME "Danger"
 #include "specenum_gen.h"
 
 struct texai_msg
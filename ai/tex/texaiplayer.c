@@ -50,7 +50,12 @@ enum texai_abort_msg_class
   TEXAI_ABORT_NONE
 };
 
+/* How many threads, the world thread included, plan phases at
+ * the same time. */
+#define TEXAI_MAX_PLANNERS 4
+
 static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait);
+static void texai_plan_phase(struct ai_type *ait);
 
 struct texai_thr
 {
@@ -59,14 +64,47 @@ struct texai_thr
   struct texai_reqs reqs_from;
   bool thread_running;
   fc_thread ait;
+
+  /* Players whose phase planning is pending. Only touched by the
+   * world thread. */
+  struct player *plan_players[MAX_NUM_PLAYER_SLOTS];
+  int num_plans;
+
+  /* Next entry of plan_players[] to be taken by a planner.
+   * Protected by plan_mutex */
+  int plan_next;
+  fc_mutex plan_mutex;
+
+  /* Set when phase of the player finishes while its planning is still
+   * running. Protected by msgs_to.mutex */
+  bool plan_abort[MAX_NUM_PLAYER_SLOTS];
 } exthrai;
 
+struct texai_planner
+{
+  struct ai_type *ait;
+  fc_thread thr;
+};
+
 struct texai_build_choice_req
 {
   int city_id;
+  int turn;
   struct adv_choice choice;
 };
 
+struct texai_danger_req
+{
+  int city_id;
+  int turn;
+  unsigned int danger;
+  unsigned int grave_danger;
+  unsigned int urgency;
+  int wallvalue;
+  bool diplomat_threat;
+  bool has_diplomat;
+};
+
 /**********************************************************************//**
   Initialize ai thread.
 **************************************************************************/
@@ -75,6 +113,7 @@ void texai_init_threading(void)
   exthrai.thread_running = FALSE;
 
   exthrai.num_players = 0;
+  exthrai.num_plans = 0;
 }
 
 /**********************************************************************//**
@@ -95,11 +134,20 @@ static void texai_thread_start(void *arg)
   /* Just wait until we are signaled to shutdown */
   fc_allocate_mutex(&exthrai.msgs_to.mutex);
   while (!finished) {
-    fc_thread_cond_wait(&exthrai.msgs_to.thr_cond, &exthrai.msgs_to.mutex);
+    if (texaimsg_list_size(exthrai.msgs_to.msglist) <= 0) {
+      fc_thread_cond_wait(&exthrai.msgs_to.thr_cond, &exthrai.msgs_to.mutex);
+    }
+
+    /* Do not keep main thread waiting while we process messages. */
+    fc_release_mutex(&exthrai.msgs_to.mutex);
 
     if (texai_check_messages(texai) <= TEXAI_ABORT_EXIT) {
       finished = TRUE;
+    } else if (exthrai.num_plans > 0) {
+      texai_plan_phase(texai);
     }
+
+    fc_allocate_mutex(&exthrai.msgs_to.mutex);
   }
   fc_release_mutex(&exthrai.msgs_to.mutex);
 
@@ -160,6 +208,211 @@ static struct unit_list *texai_player_units(struct player *pplayer)
   return plr_data->units;
 }
 
+/**********************************************************************//**
+  Has the phase of the player, or the whole thread, ended while we are
+  still planning for the player.
+**************************************************************************/
+static bool texai_plan_aborted(struct player *pplayer)
+{
+  bool ret;
+
+  fc_allocate_mutex(&exthrai.msgs_to.mutex);
+  ret = exthrai.plan_abort[player_index(pplayer)];
+  fc_release_mutex(&exthrai.msgs_to.mutex);
+
+  return ret;
+}
+
+/**********************************************************************//**
+  Queue phase planning for the player. Planning itself takes place once
+  the message queue has been emptied, so that the world copy is up to
+  date and stays unchanged while planners are reading it.
+**************************************************************************/
+static void texai_plan_add(struct player *pplayer)
+{
+  int i;
+
+  fc_allocate_mutex(&exthrai.msgs_to.mutex);
+  exthrai.plan_abort[player_index(pplayer)] = FALSE;
+  fc_release_mutex(&exthrai.msgs_to.mutex);
+
+  for (i = 0; i < exthrai.num_plans; i++) {
+    if (exthrai.plan_players[i] == pplayer) {
+      return;
+    }
+  }
+
+  exthrai.plan_players[exthrai.num_plans++] = pplayer;
+}
+
+/**********************************************************************//**
+  Phase of the player finished before its planning started. Forget it,
+  but still tell main thread that we are done.
+**************************************************************************/
+static void texai_plan_remove(struct player *pplayer)
+{
+  int i;
+
+  for (i = 0; i < exthrai.num_plans; i++) {
+    if (exthrai.plan_players[i] == pplayer) {
+      exthrai.plan_players[i] = exthrai.plan_players[--exthrai.num_plans];
+      texai_send_req(TEXAI_REQ_TURN_DONE, pplayer, NULL);
+      return;
+    }
+  }
+}
+
+/**********************************************************************//**
+  Send danger assessment made in the world copy to the main thread.
+**************************************************************************/
+static void texai_danger_send(struct ai_type *ait, struct player *pplayer,
+                              struct city *tex_city)
+{
+  struct ai_city *city_data = def_ai_city_data(tex_city, ait);
+  struct texai_danger_req *danger_req
+    = fc_malloc(sizeof(struct texai_danger_req));
+
+  danger_req->city_id = tex_city->id;
+  danger_req->turn = game.info.turn;
+  danger_req->danger = city_data->danger;
+  danger_req->grave_danger = city_data->grave_danger;
+  danger_req->urgency = city_data->urgency;
+  danger_req->wallvalue = city_data->wallvalue;
+  danger_req->diplomat_threat = city_data->diplomat_threat;
+  danger_req->has_diplomat = city_data->has_diplomat;
+
+  texai_send_req(TEXAI_REQ_DANGER, pplayer, danger_req);
+}
+
+/**********************************************************************//**
+  Make phase plans for one player. Decisions are sent to the main thread
+  as requests, it validates them before applying.
+
+  Several planners run at the same time, each for different player.
+  World copy is read-only while they run. Real cities of the player
+  are accessed only while holding city list mutex.
+**************************************************************************/
+static void texai_plan_player(struct ai_type *ait, struct player *pplayer)
+{
+  fc_allocate_mutex(&game.server.mutexes.city_list);
+
+  initialize_infrastructure_cache(pplayer);
+
+  /* Use _safe iterate in case the main thread
+   * destroyes cities while we are iterating through these. */
+  city_list_iterate_safe(pplayer->cities, pcity) {
+    struct city *tex_city = texai_map_city(pcity->id);
+
+    texai_city_worker_requests_create(ait, pplayer, pcity);
+    texai_city_worker_wants(ait, pplayer, pcity);
+
+    /* Release mutex while working on the world copy only,
+     * so that other planners and the main thread can proceed. */
+    fc_release_mutex(&game.server.mutexes.city_list);
+
+    if (tex_city != NULL) {
+      struct adv_choice *choice;
+      struct texai_build_choice_req *choice_req
+        = fc_malloc(sizeof(struct texai_build_choice_req));
+
+      choice = military_advisor_choose_build(ait, pplayer, tex_city,
+                                             texai_map_get(), texai_player_units);
+      choice_req->city_id = tex_city->id;
+      choice_req->turn = game.info.turn;
+      adv_choice_copy(&(choice_req->choice), choice);
+      adv_free_choice(choice);
+      texai_send_req(TEXAI_BUILD_CHOICE, pplayer, choice_req);
+
+      /* military_advisor_choose_build() assessed danger as a side effect */
+      texai_danger_send(ait, pplayer, tex_city);
+    }
+
+    fc_allocate_mutex(&game.server.mutexes.city_list);
+
+    if (texai_plan_aborted(pplayer)) {
+      break;
+    }
+  } city_list_iterate_safe_end;
+
+  fc_release_mutex(&game.server.mutexes.city_list);
+
+  texai_send_req(TEXAI_REQ_TURN_DONE, pplayer, NULL);
+}
+
+/**********************************************************************//**
+  Take next player whose phase is still to be planned, or NULL if there
+  is none left.
+**************************************************************************/
+static struct player *texai_plan_next(void)
+{
+  struct player *pplayer = NULL;
+
+  fc_allocate_mutex(&exthrai.plan_mutex);
+  if (exthrai.plan_next < exthrai.num_plans) {
+    pplayer = exthrai.plan_players[exthrai.plan_next++];
+  }
+  fc_release_mutex(&exthrai.plan_mutex);
+
+  return pplayer;
+}
+
+/**********************************************************************//**
+  Plan phases of pending players until there is none left.
+**************************************************************************/
+static void texai_plan_pending(struct ai_type *ait)
+{
+  struct player *pplayer;
+
+  while ((pplayer = texai_plan_next()) != NULL) {
+    texai_plan_player(ait, pplayer);
+  }
+}
+
+/**********************************************************************//**
+  Planner thread main function.
+**************************************************************************/
+static void texai_planner_start(void *arg)
+{
+  struct texai_planner *planner = (struct texai_planner *)arg;
+
+  texai_plan_pending(planner->ait);
+}
+
+/**********************************************************************//**
+  Run all pending phase plans and wait until they have all finished.
+  At most TEXAI_MAX_PLANNERS players are planned at the same time, this
+  thread being one of the planners. Messages arriving meanwhile are left
+  in the queue and get handled only after this.
+**************************************************************************/
+static void texai_plan_phase(struct ai_type *ait)
+{
+  struct texai_planner planners[TEXAI_MAX_PLANNERS - 1];
+  int num_helpers = MIN(exthrai.num_plans, TEXAI_MAX_PLANNERS) - 1;
+  int started = 0;
+  int i;
+
+  exthrai.plan_next = 0;
+
+  for (i = 0; i < num_helpers; i++) {
+    planners[started].ait = ait;
+    if (fc_thread_start(&planners[started].thr, texai_planner_start,
+                        &planners[started]) == 0) {
+      started++;
+    } else {
+      /* Could not get a thread, the remaining planners take its share. */
+      log_debug("Could not start a phase planner thread");
+    }
+  }
+
+  texai_plan_pending(ait);
+
+  for (i = 0; i < started; i++) {
+    fc_thread_wait(&planners[i].thr);
+  }
+
+  exthrai.num_plans = 0;
+}
+
 /**********************************************************************//**
   Handle messages from message queue.
 **************************************************************************/
@@ -180,45 +433,7 @@ static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait)
 
     switch(msg->type) {
     case TEXAI_MSG_FIRST_ACTIVITIES:
-      fc_allocate_mutex(&game.server.mutexes.city_list);
-
-      initialize_infrastructure_cache(msg->plr);
-
-      /* Use _safe iterate in case the main thread
-       * destroyes cities while we are iterating through these. */
-      city_list_iterate_safe(msg->plr->cities, pcity) {
-        struct adv_choice *choice;
-        struct texai_build_choice_req *choice_req
-          = fc_malloc(sizeof(struct texai_build_choice_req));
-        struct city *tex_city = texai_map_city(pcity->id);
-
-        texai_city_worker_requests_create(ait, msg->plr, pcity);
-        texai_city_worker_wants(ait, msg->plr, pcity);
-
-        if (tex_city != NULL) {
-          choice = military_advisor_choose_build(ait, msg->plr, tex_city,
-                                                 texai_map_get(), texai_player_units);
-          choice_req->city_id = tex_city->id;
-          adv_choice_copy(&(choice_req->choice), choice);
-          adv_free_choice(choice);
-          texai_send_req(TEXAI_BUILD_CHOICE, msg->plr, choice_req);
-        }
-
-        /* Release mutex for a second in case main thread
-         * wants to do something to city list. */
-        fc_release_mutex(&game.server.mutexes.city_list);
-
-        /* Recursive message check in case phase is finished. */
-        new_abort = texai_check_messages(ait);
-        fc_allocate_mutex(&game.server.mutexes.city_list);
-        if (new_abort < TEXAI_ABORT_NONE) {
-          break;
-        }
-      } city_list_iterate_safe_end;
-      fc_release_mutex(&game.server.mutexes.city_list);
-
-      texai_send_req(TEXAI_REQ_TURN_DONE, msg->plr, NULL);
-
+      texai_plan_add(msg->plr);
       break;
     case TEXAI_MSG_TILE_INFO:
       texai_tile_info_recv(msg->data);
@@ -239,6 +454,7 @@ static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait)
       texai_city_destruction_recv(msg->data);
       break;
     case TEXAI_MSG_PHASE_FINISHED:
+      texai_plan_remove(msg->plr);
       new_abort = TEXAI_ABORT_PHASE_END;
       break;
     case TEXAI_MSG_THR_EXIT:
@@ -312,13 +528,14 @@ void texai_control_gained(struct ai_type *ait, struct player *pplayer)
             exthrai.num_players);
 
   if (!exthrai.thread_running) {
-    exthrai.msgs_to.msglist = texaimsg_list_new();
-    exthrai.reqs_from.reqlist = texaireq_list_new();
+    exthrai.msgs_to.msglist = texaimsg_list_new_mutexed();
+    exthrai.reqs_from.reqlist = texaireq_list_new_mutexed();
 
     exthrai.thread_running = TRUE;
  
     fc_thread_cond_init(&exthrai.msgs_to.thr_cond);
     fc_init_mutex(&exthrai.msgs_to.mutex);
+    fc_init_mutex(&exthrai.plan_mutex);
     fc_thread_start(&exthrai.ait, texai_thread_start, ait);
   }
 }
@@ -341,6 +558,7 @@ void texai_control_lost(struct ai_type *ait, struct player *pplayer)
 
     fc_thread_cond_destroy(&exthrai.msgs_to.thr_cond);
     fc_destroy_mutex(&exthrai.msgs_to.mutex);
+    fc_destroy_mutex(&exthrai.plan_mutex);
     texaimsg_list_destroy(exthrai.msgs_to.msglist);
     texaireq_list_destroy(exthrai.reqs_from.reqlist);
   }
@@ -373,11 +591,34 @@ void texai_refresh(struct ai_type *ait, struct player *pplayer)
              = (struct texai_build_choice_req *)(req->data);
            struct city *pcity = game_city_by_number(choice_req->city_id);
 
-           if (pcity != NULL && city_owner(pcity) == req->plr) {
+           if (pcity != NULL && city_owner(pcity) == req->plr
+               && choice_req->turn == game.info.turn) {
              adv_choice_copy(&(def_ai_city_data(pcity, ait)->choice),
                              &(choice_req->choice));
-             FC_FREE(choice_req);
            }
+           FC_FREE(choice_req);
+         }
+         break;
+       case TEXAI_REQ_DANGER:
+         {
+           struct texai_danger_req *danger_req
+             = (struct texai_danger_req *)(req->data);
+           struct city *pcity = game_city_by_number(danger_req->city_id);
+
+           /* City may have been lost, or turn changed,
+            * since the assessment was made. */
+           if (pcity != NULL && city_owner(pcity) == req->plr
+               && danger_req->turn == game.info.turn) {
+             struct ai_city *city_data = def_ai_city_data(pcity, ait);
+
+             city_data->danger = danger_req->danger;
+             city_data->grave_danger = danger_req->grave_danger;
+             city_data->urgency = danger_req->urgency;
+             city_data->wallvalue = danger_req->wallvalue;
+             city_data->diplomat_threat = danger_req->diplomat_threat;
+             city_data->has_diplomat = danger_req->has_diplomat;
+           }
+           FC_FREE(danger_req);
          }
          break;
        case TEXAI_REQ_TURN_DONE:
@@ -400,7 +641,22 @@ void texai_refresh(struct ai_type *ait, struct player *pplayer)
 void texai_msg_to_thr(struct texai_msg *msg)
 {
   fc_allocate_mutex(&exthrai.msgs_to.mutex);
+
+  /* Running planners check these without waiting for the message
+   * to be handled. */
+  if (msg->type == TEXAI_MSG_THR_EXIT) {
+    int i;
+
+    for (i = 0; i < MAX_NUM_PLAYER_SLOTS; i++) {
+      exthrai.plan_abort[i] = TRUE;
+    }
+  } else if (msg->type == TEXAI_MSG_PHASE_FINISHED) {
+    exthrai.plan_abort[player_index(msg->plr)] = TRUE;
+  }
+
+  texaimsg_list_allocate_mutex(exthrai.msgs_to.msglist);
   texaimsg_list_append(exthrai.msgs_to.msglist, msg);
+  texaimsg_list_release_mutex(exthrai.msgs_to.msglist);
   fc_thread_cond_signal(&exthrai.msgs_to.thr_cond);
   fc_release_mutex(&exthrai.msgs_to.mutex);
 }
@@ -200,8 +200,8 @@ void tai_control_gained(struct ai_type *ait, struct player *pplayer)
   log_debug("%s now under threaded AI (%d)", pplayer->name, thrai.num_players);
 
   if (!thrai.thread_running) {
-    thrai.msgs_to.msglist = taimsg_list_new();
-    thrai.reqs_from.reqlist = taireq_list_new();
+    thrai.msgs_to.msglist = taimsg_list_new_mutexed();
+    thrai.reqs_from.reqlist = taireq_list_new_mutexed();
 
     thrai.thread_running = TRUE;
  
@@ -56,6 +56,11 @@
 
 #include "cma_core.h"
 
+/* Hash of the city state the governor last settled, keyed by city id. */
+#define SPECHASH_TAG cma_state
+#define SPECHASH_INT_KEY_TYPE
+#define SPECHASH_INT_DATA_TYPE
+#include "spechash.h"
 
 /*
  * The CMA is an agent. The CMA will subscribe itself to all city
@@ -86,8 +91,17 @@
 static struct {
   struct timer *wall_timer;
   int apply_result_ignored, apply_result_applied, refresh_forced;
+  int city_unchanged;
 } stats;
 
+/*
+ * For each governed city, a hash of everything the CM looks at, taken
+ * after the last successful run. City packets that don't change any of
+ * it (stock updates, production changes, our own replies arriving late)
+ * then don't cause another CM query.
+ */
+static struct cma_state_hash *settled_states = NULL;
+
 
 /************************************************************************//**
   Returns TRUE iff the two results are equal. Both results have to be
@@ -337,14 +351,77 @@ static void report_stats(void)
            per_mill / 10, per_mill % 10, stats.apply_result_ignored,
            (1000 - per_mill) / 10, (1000 - per_mill) % 10,
            stats.apply_result_applied, total);
+  log_test("CMA: %d unchanged cities skipped", stats.city_unchanged);
 #endif /* SHOW_TIME_STATS */
 }
 
+/************************************************************************//**
+  Mix one value into the state hash.
+****************************************************************************/
+static inline void state_hash_add(unsigned int *hash, int value)
+{
+  *hash = (*hash ^ (unsigned int) value) * 16777619u;
+}
+
+/************************************************************************//**
+  Return a hash of the city state and governor parameter the CM result
+  depends on: size, workable tiles and their output, specialists,
+  buildings and the resulting city output and happiness.
+****************************************************************************/
+static int city_state_hash(const struct city *pcity,
+                           const struct cm_parameter *parameter)
+{
+  unsigned int hash = 2166136261u;
+  int city_radius_sq = city_map_radius_sq_get(pcity);
+  enum citizen_category cit;
+
+  state_hash_add(&hash, city_size_get(pcity));
+  state_hash_add(&hash, city_radius_sq);
+  state_hash_add(&hash, government_number(government_of_city(pcity)));
+
+  output_type_iterate(o) {
+    state_hash_add(&hash, parameter->minimal_surplus[o]);
+    state_hash_add(&hash, parameter->factor[o]);
+    state_hash_add(&hash, pcity->prod[o]);
+    state_hash_add(&hash, pcity->surplus[o]);
+    state_hash_add(&hash, pcity->waste[o]);
+    state_hash_add(&hash, pcity->usage[o]);
+  } output_type_iterate_end;
+  state_hash_add(&hash, parameter->happy_factor);
+  state_hash_add(&hash, parameter->require_happy);
+
+  specialist_type_iterate(sp) {
+    state_hash_add(&hash, pcity->specialists[sp]);
+  } specialist_type_iterate_end;
+
+  for (cit = CITIZEN_HAPPY; cit < CITIZEN_LAST; cit++) {
+    state_hash_add(&hash, pcity->feel[cit][FEELING_FINAL]);
+  }
+
+  city_built_iterate(pcity, pimprove) {
+    state_hash_add(&hash, improvement_number(pimprove));
+  } city_built_iterate_end;
+
+  city_tile_iterate_index(city_radius_sq, city_tile(pcity), ptile, idx) {
+    struct city *pworking = tile_worked(ptile);
+
+    state_hash_add(&hash, idx);
+    state_hash_add(&hash, pworking == pcity ? 1 : (pworking ? 2 : 0));
+    state_hash_add(&hash, city_can_work_tile(pcity, ptile));
+    output_type_iterate(o) {
+      state_hash_add(&hash, city_tile_output_now(pcity, ptile, o));
+    } output_type_iterate_end;
+  } city_tile_iterate_index_end;
+
+  return (int) hash;
+}
+
 /************************************************************************//**
   Remove governor setting from city.
 ****************************************************************************/
 static void release_city(int city_id)
 {
+  cma_state_hash_remove(settled_states, city_id);
   attr_city_set(ATTR_CITY_CMA_PARAMETER, city_id, 0, NULL);
 }
 
@@ -404,6 +481,10 @@ static void handle_city(struct city *pcity)
       } else {
         log_handle_city2("  ok");
         /* Everything ok */
+        if (pcity == check_city(city_id, &parameter)) {
+          cma_state_hash_replace(settled_states, city_id,
+                                 city_state_hash(pcity, &parameter));
+        }
         handled = TRUE;
         break;
       }
@@ -436,8 +517,18 @@ static void handle_city(struct city *pcity)
 static void city_changed(int city_id)
 {
   struct city *pcity = game_city_by_number(city_id);
+  struct cm_parameter parameter;
+  int settled;
 
   if (pcity) {
+    if (cma_state_hash_lookup(settled_states, city_id, &settled)
+        && pcity == check_city(city_id, &parameter)
+        && settled == city_state_hash(pcity, &parameter)) {
+      /* Nothing the CM looks at has changed since the last run. */
+      stats.city_unchanged++;
+      return;
+    }
+
     cm_clear_cache(pcity);
     handle_city(pcity);
   }
@@ -481,6 +572,12 @@ void cma_init(void)
    * leaks. */
   stats.wall_timer = timer_renew(timer, TIMER_USER, TIMER_ACTIVE);
 
+  if (settled_states != NULL) {
+    cma_state_hash_clear(settled_states);
+  } else {
+    settled_states = cma_state_hash_new();
+  }
+
   memset(&self, 0, sizeof(self));
   strcpy(self.name, "CMA");
   self.level = 1;
@@ -515,6 +612,7 @@ void cma_put_city_under_agent(struct city *pcity,
   fc_assert_ret(city_owner(pcity) == client.conn.playing);
 
   cma_set_parameter(ATTR_CITY_CMA_PARAMETER, pcity->id, parameter);
+  cma_state_hash_remove(settled_states, pcity->id);
 
   cause_a_city_changed_for_agent("CMA", pcity);
 
@@ -284,6 +284,11 @@ static void client_game_free(void)
   game.client.ruleset_init = FALSE;
   game.client.ruleset_ready = FALSE;
   game_free();
+  /* The connection may have been lost between PACKET_FREEZE_CLIENT and
+   * PACKET_THAW_CLIENT. Don't leave the update queue frozen for the next
+   * connection. */
+  update_queue_force_thaw();
+  mapview_updates_thaw();
   /* update_queue_init() is correct at this point. The queue is reset to
      a clean state which is also needed if the client is not connected to
      the server! */
@@ -34,11 +34,13 @@
 /* client/include */
 #include "client_main.h"
 #include "control.h"
+#include "gui_main_g.h"
 #include "mapview_g.h"
 
 /* client */
 #include "goto.h"
 #include "mapctrl_common.h"
+#include "mapview_common.h"
 
 #define LOG_GOTO_PATH           LOG_DEBUG
 #define log_goto_path           log_debug
@@ -54,6 +56,7 @@ struct part {
   int end_moves_left, end_fuel_left;
   struct pf_path *path;
   struct pf_map *map;
+  bool expanded;        /* No more idle time expansion of 'map' wanted. */
 };
 
 struct goto_map {
@@ -91,6 +94,10 @@ struct goto_map {
 static struct goto_map_list *goto_maps = NULL;
 static bool goto_warned = FALSE;
 
+/* Number of pf_map positions expanded per idle callback. */
+#define GOTO_EXPAND_STEP 64
+static bool goto_expand_queued = FALSE;
+
 static void reset_last_part(struct goto_map *goto_map);
 static void remove_last_part(struct goto_map *goto_map);
 static void fill_parameter_part(struct pf_parameter *param,
@@ -423,6 +430,53 @@ static void fill_parameter_part(struct pf_parameter *param,
   }
 }
 
+/************************************************************************//**
+  Idle callback expanding the map of the last part of each goto while the
+  user is not doing anything. Hover queries within the expanded area are
+  then simple lookups in pf_map_path(). The expansion stops when the map
+  is exhausted or when a whole step reached no tile in the visible area.
+****************************************************************************/
+static void goto_expand_callback(void *data)
+{
+  bool more = FALSE;
+
+  goto_expand_queued = FALSE;
+
+  if (!goto_is_active()) {
+    return;
+  }
+
+  goto_map_list_iterate(goto_maps, goto_map) {
+    struct part *p = &goto_map->parts[goto_map->num_parts - 1];
+    bool visible = FALSE;
+    int i;
+
+    if (p->expanded) {
+      continue;
+    }
+
+    for (i = 0; i < GOTO_EXPAND_STEP; i++) {
+      if (!pf_map_iterate(p->map)) {
+        break;
+      }
+      if (tile_visible_mapcanvas(pf_map_iter(p->map))) {
+        visible = TRUE;
+      }
+    }
+
+    if (i < GOTO_EXPAND_STEP || !visible) {
+      p->expanded = TRUE;
+    } else {
+      more = TRUE;
+    }
+  } goto_map_list_iterate_end;
+
+  if (more) {
+    goto_expand_queued = TRUE;
+    add_idle_callback(goto_expand_callback, NULL);
+  }
+}
+
 /************************************************************************//**
   Add a part. Depending on the num of already existing parts the start
   of the new part is either the unit position (for the first part) or
@@ -454,6 +508,12 @@ static void add_part(struct goto_map *goto_map)
   p->end_tile = p->start_tile;
   parameter.start_tile = p->start_tile;
   p->map = pf_map_new(&parameter);
+  p->expanded = FALSE;
+
+  if (!goto_expand_queued) {
+    goto_expand_queued = TRUE;
+    add_idle_callback(goto_expand_callback, NULL);
+  }
 }
 
 /************************************************************************//**
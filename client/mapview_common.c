@@ -44,6 +44,7 @@
 #include "citydlg_common.h"
 #include "overview_common.h"
 #include "tilespec.h"
+#include "update_queue.h"
 #include "zoom.h"
 
 #include "mapview_common.h"
@@ -112,6 +113,43 @@ struct trade_route_line {
 /* A trade route line might need to be drawn in two parts. */
 static const int MAX_TRADE_ROUTE_DRAW_LINES = 2;
 
+/* Tile render cache. Sprites of the terrain layers depend only on the
+ * tile itself and on its adjacent tiles, but resolving them (terrain
+ * matching, rivers, roads) is the most expensive part of drawing a tile.
+ * They are kept here between redraws, keyed by a hash of everything
+ * that affects them, and resolved again only when that changes.
+ *
+ * Entries are recycled with the clock algorithm, so only about as many
+ * tiles as fit on the mapview are cached at a time. */
+#define TILE_CACHE_LAYERS 6
+#define TILE_CACHE_SPRITES 24
+
+static const enum mapview_layer tile_cache_layers[TILE_CACHE_LAYERS] = {
+  LAYER_TERRAIN1, LAYER_DARKNESS, LAYER_TERRAIN2, LAYER_TERRAIN3,
+  LAYER_WATER, LAYER_ROADS
+};
+
+struct tile_cache_entry {
+  int tindex;              /* -1 if entry not in use */
+  unsigned int key;
+  unsigned int pass;       /* Drawing pass where key was last checked */
+  bool used;               /* Reference bit for the clock algorithm */
+  bool overflow;           /* Did not fit, draw without cache */
+  unsigned char first[TILE_CACHE_LAYERS + 1];
+  struct drawn_sprite sprs[TILE_CACHE_SPRITES];
+};
+
+static struct {
+  struct tile_cache_entry *entries;
+  int num_entries;
+  int hand;
+  int *tile_entry;         /* Entry of each map tile, or -1 */
+  int num_tiles;
+  unsigned int pass;
+} tile_cache = { NULL, 0, 0, NULL, 0, 0 };
+
+static void tile_cache_invalidate(const struct tile *ptile);
+
 static struct timer *anim_timer = NULL;
 
 enum animation_type { ANIM_MOVEMENT, ANIM_BATTLE, ANIM_EXPL, ANIM_NUKE };
@@ -460,6 +498,8 @@ static void gotoline_counter_destroy(struct gotoline_counter *pglc)
 void refresh_tile_mapcanvas(struct tile *ptile,
                             bool full_refresh, bool write_to_screen)
 {
+  tile_cache_invalidate(ptile);
+
   if (full_refresh) {
     queue_mapview_tile_update(ptile, TILE_UPDATE_TILE_FULL);
   } else {
@@ -1519,6 +1559,279 @@ void put_nuke_mushroom_pixmaps(struct tile *ptile)
   }
 }
 
+/************************************************************************//**
+  Forget everything in the tile render cache. Must be called whenever
+  sprites may have changed under it, such as when tileset gets loaded.
+****************************************************************************/
+void tile_cache_flush(void)
+{
+  int i;
+
+  for (i = 0; i < tile_cache.num_entries; i++) {
+    tile_cache.entries[i].tindex = -1;
+  }
+  for (i = 0; i < tile_cache.num_tiles; i++) {
+    tile_cache.tile_entry[i] = -1;
+  }
+  tile_cache.hand = 0;
+}
+
+/************************************************************************//**
+  Free tile render cache.
+****************************************************************************/
+static void tile_cache_free(void)
+{
+  if (tile_cache.entries != NULL) {
+    free(tile_cache.entries);
+    tile_cache.entries = NULL;
+  }
+  if (tile_cache.tile_entry != NULL) {
+    free(tile_cache.tile_entry);
+    tile_cache.tile_entry = NULL;
+  }
+  tile_cache.num_entries = 0;
+  tile_cache.num_tiles = 0;
+  tile_cache.hand = 0;
+}
+
+/************************************************************************//**
+  Make tile render cache big enough for the current map and mapview size.
+****************************************************************************/
+static void tile_cache_resize(void)
+{
+  int num_tiles = map_is_empty() ? 0 : MAP_INDEX_SIZE;
+  /* Twice the tiles visible, so that scrolling back and forth
+   * does not evict anything still on the screen. */
+  int num_entries = 2 * mapview.tile_width * mapview.tile_height
+    * (tileset_is_isometric(tileset) ? 2 : 1);
+
+  num_entries = MIN(MAX(num_entries, 256), MAX(num_tiles, 1));
+
+  if (num_tiles == tile_cache.num_tiles
+      && num_entries <= tile_cache.num_entries) {
+    return;
+  }
+
+  tile_cache_free();
+
+  if (num_tiles > 0) {
+    tile_cache.entries = fc_malloc(num_entries * sizeof(*tile_cache.entries));
+    tile_cache.num_entries = num_entries;
+    tile_cache.tile_entry = fc_malloc(num_tiles * sizeof(*tile_cache.tile_entry));
+    tile_cache.num_tiles = num_tiles;
+    tile_cache_flush();
+  }
+}
+
+/************************************************************************//**
+  Tile has changed. Drop it, and its adjacent tiles whose terrain
+  matching depends on it, from the tile render cache.
+****************************************************************************/
+static void tile_cache_invalidate(const struct tile *ptile)
+{
+  int i;
+
+  if (tile_cache.tile_entry == NULL) {
+    return;
+  }
+
+  i = tile_cache.tile_entry[tile_index(ptile)];
+  if (i >= 0) {
+    tile_cache.entries[i].tindex = -1;
+    tile_cache.tile_entry[tile_index(ptile)] = -1;
+  }
+
+  adjc_iterate(&(wld.map), ptile, adjc_tile) {
+    i = tile_cache.tile_entry[tile_index(adjc_tile)];
+    if (i >= 0) {
+      tile_cache.entries[i].tindex = -1;
+      tile_cache.tile_entry[tile_index(adjc_tile)] = -1;
+    }
+  } adjc_iterate_end;
+}
+
+/************************************************************************//**
+  Mix data into tile appearance hash.
+****************************************************************************/
+static inline unsigned int tile_cache_hash_mix(unsigned int hash,
+                                               const void *data,
+                                               size_t len)
+{
+  const unsigned char *bytes = data;
+  size_t i;
+
+  for (i = 0; i < len; i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+
+  return hash;
+}
+
+/************************************************************************//**
+  Hash of everything that affects the cached layers of the tile: the
+  tile and its adjacent tiles as the client knows them, city presence,
+  and the drawing options.
+****************************************************************************/
+static unsigned int tile_appearance_hash(const struct tile *ptile,
+                                         const struct city *pcity)
+{
+  unsigned int hash = 2166136261u;
+  unsigned char opts[10];
+  int dir;
+
+  opts[0] = gui_options.draw_terrain;
+  opts[1] = gui_options.draw_cities;
+  opts[2] = gui_options.draw_irrigation;
+  opts[3] = gui_options.draw_pollution;
+  opts[4] = gui_options.draw_mines;
+  opts[5] = gui_options.draw_specials;
+  opts[6] = gui_options.draw_huts;
+  opts[7] = gui_options.draw_fortress_airbase;
+  opts[8] = gui_options.draw_roads_rails;
+  opts[9] = (pcity != NULL);
+  hash = tile_cache_hash_mix(hash, opts, sizeof(opts));
+  hash = tile_cache_hash_mix(hash, &ptile->spec_sprite,
+                             sizeof(ptile->spec_sprite));
+
+  for (dir = -1; dir < 8; dir++) {
+    const struct tile *tile1 = (dir < 0 ? ptile
+                                : mapstep(&(wld.map), ptile, dir));
+    int state[2] = { -1, -1 };
+
+    if (tile1 != NULL) {
+      state[0] = client_tile_get_known(tile1);
+      if (state[0] != TILE_UNKNOWN && tile_terrain(tile1) != NULL) {
+        state[1] = terrain_number(tile_terrain(tile1));
+      }
+    }
+    hash = tile_cache_hash_mix(hash, state, sizeof(state));
+    if (state[1] >= 0) {
+      hash = tile_cache_hash_mix(hash, tile_extras(tile1),
+                                 sizeof(*tile_extras(tile1)));
+    }
+  }
+
+  return hash;
+}
+
+/************************************************************************//**
+  Take a new cache entry into use for the tile, evicting some old one.
+****************************************************************************/
+static struct tile_cache_entry *tile_cache_entry_new(const struct tile *ptile)
+{
+  struct tile_cache_entry *pentry;
+  int i;
+
+  /* Clock algorithm: skip over recently used entries, clearing
+   * their reference bit as we go. */
+  for (;;) {
+    i = tile_cache.hand;
+    pentry = &tile_cache.entries[i];
+    tile_cache.hand = (i + 1) % tile_cache.num_entries;
+
+    if (pentry->tindex < 0 || !pentry->used) {
+      break;
+    }
+    pentry->used = FALSE;
+  }
+
+  if (pentry->tindex >= 0) {
+    tile_cache.tile_entry[pentry->tindex] = -1;
+  }
+  pentry->tindex = tile_index(ptile);
+  tile_cache.tile_entry[pentry->tindex] = i;
+
+  return pentry;
+}
+
+/************************************************************************//**
+  Fill all cached layers of the tile to cache entry.
+****************************************************************************/
+static void tile_cache_entry_fill(struct tile_cache_entry *pentry,
+                                  const struct tile *ptile,
+                                  const struct city *pcity)
+{
+  struct drawn_sprite tile_sprs[80];
+  int i, count = 0;
+
+  pentry->overflow = FALSE;
+  for (i = 0; i < TILE_CACHE_LAYERS; i++) {
+    int lcount = fill_sprite_array(tileset, tile_sprs, tile_cache_layers[i],
+                                   ptile, NULL, NULL, NULL, pcity,
+                                   NULL, NULL);
+
+    pentry->first[i] = count;
+    if (count + lcount > TILE_CACHE_SPRITES) {
+      pentry->overflow = TRUE;
+      return;
+    }
+    memcpy(pentry->sprs + count, tile_sprs, lcount * sizeof(tile_sprs[0]));
+    count += lcount;
+  }
+  pentry->first[TILE_CACHE_LAYERS] = count;
+}
+
+/************************************************************************//**
+  Draw one layer of the tile from tile render cache. Returns FALSE if
+  the layer is not cacheable, and the caller has to draw it normally.
+****************************************************************************/
+static bool put_one_tile_cached(struct canvas *pcanvas,
+                                enum mapview_layer layer,
+                                const struct tile *ptile,
+                                const struct city *pcity,
+                                int canvas_x, int canvas_y)
+{
+  struct tile_cache_entry *pentry;
+  int lidx, i;
+
+  if (tile_cache.tile_entry == NULL
+      || gui_options.solid_color_behind_units) {
+    /* Terrain layers then depend on units, too. */
+    return FALSE;
+  }
+
+  for (lidx = 0; lidx < TILE_CACHE_LAYERS; lidx++) {
+    if (tile_cache_layers[lidx] == layer) {
+      break;
+    }
+  }
+  if (lidx >= TILE_CACHE_LAYERS) {
+    return FALSE;
+  }
+
+  i = tile_cache.tile_entry[tile_index(ptile)];
+  pentry = (i >= 0 ? &tile_cache.entries[i] : NULL);
+
+  if (pentry == NULL || pentry->pass != tile_cache.pass) {
+    /* First cached layer of the tile on this drawing pass.
+     * Check that cached sprites are still valid. */
+    unsigned int key = tile_appearance_hash(ptile, pcity);
+
+    if (pentry == NULL) {
+      pentry = tile_cache_entry_new(ptile);
+      pentry->key = key;
+      tile_cache_entry_fill(pentry, ptile, pcity);
+    } else if (pentry->key != key) {
+      pentry->key = key;
+      tile_cache_entry_fill(pentry, ptile, pcity);
+    }
+    pentry->pass = tile_cache.pass;
+  }
+  pentry->used = TRUE;
+
+  if (pentry->overflow) {
+    return FALSE;
+  }
+
+  put_drawn_sprites(pcanvas, map_zoom, canvas_x, canvas_y,
+                    pentry->first[lidx + 1] - pentry->first[lidx],
+                    pentry->sprs + pentry->first[lidx],
+                    gui_options.draw_fog_of_war
+                    && TILE_KNOWN_UNSEEN == client_tile_get_known(ptile));
+
+  return TRUE;
+}
+
 /************************************************************************//**
   Draw some or all of a tile onto the canvas.
 ****************************************************************************/
@@ -1540,6 +1853,12 @@ static void put_one_tile(struct canvas *pcanvas, enum mapview_layer layer,
       punit = NULL;
     }
 
+    if (citymode == NULL && client_tile_get_known(ptile) != TILE_UNKNOWN
+        && put_one_tile_cached(pcanvas, layer, ptile, tile_city(ptile),
+                               canvas_x, canvas_y)) {
+      return;
+    }
+
     put_one_element(pcanvas, map_zoom, layer, ptile, NULL, NULL, punit,
                     tile_city(ptile), canvas_x, canvas_y, citymode, NULL);
   }
@@ -1698,6 +2017,9 @@ void update_map_canvas(int canvas_x, int canvas_y, int width, int height)
   log_debug("update_map_canvas(pos=(%d,%d), size=(%d,%d))",
             canvas_x, canvas_y, width, height);
 
+  /* Cached tiles get their validity checked once per pass. */
+  tile_cache.pass++;
+
   /* If a full redraw is done, we just draw everything onto the canvas.
    * However if a partial redraw is done we draw everything onto the
    * tmp_canvas then copy *just* the area of update onto the canvas. */
@@ -2938,6 +3260,11 @@ static bool callback_queued = FALSE;
  * direction. */
 struct tile_list *tile_updates[TILE_UPDATE_COUNT];
 
+/* Bit (1 << type) is set for each tile already in tile_updates[type], so
+ * that a burst of packets about the same tiles queues each only once. */
+static unsigned char *tile_updates_queued = NULL;
+static int tile_updates_queued_size = 0;
+
 /************************************************************************//**
   This callback is called during an idle moment to unqueue any pending
   mapview updates.
@@ -2945,6 +3272,11 @@ struct tile_list *tile_updates[TILE_UPDATE_COUNT];
 static void queue_callback(void *data)
 {
   callback_queued = FALSE;
+  if (update_queue_is_frozen()) {
+    /* Packet burst in progress. Updates are done when it has ended,
+     * see mapview_updates_thaw(). */
+    return;
+  }
   unqueue_mapview_updates(TRUE);
 }
 
@@ -2996,14 +3328,54 @@ void queue_mapview_tile_update(struct tile *ptile,
                                enum tile_update_type type)
 {
   if (can_client_change_view()) {
+    int idx = tile_index(ptile);
+
+    if (tile_updates_queued_size != MAP_INDEX_SIZE) {
+      free(tile_updates_queued);
+      tile_updates_queued_size = MAP_INDEX_SIZE;
+      tile_updates_queued = fc_calloc(tile_updates_queued_size,
+                                      sizeof(*tile_updates_queued));
+    }
+
+    if (tile_updates[type] != NULL
+        && (tile_updates_queued[idx] & (1 << type))) {
+      /* Already queued. */
+      return;
+    }
+
     if (!tile_updates[type]) {
       tile_updates[type] = tile_list_new();
     }
     tile_list_append(tile_updates[type], ptile);
+    tile_updates_queued[idx] |= (1 << type);
     queue_add_callback();
   }
 }
 
+/************************************************************************//**
+  Called when the update queue is thawed after a packet burst. Schedule
+  the mapview updates that were held back meanwhile.
+****************************************************************************/
+void mapview_updates_thaw(void)
+{
+  int i;
+
+  if (update_queue_is_frozen()) {
+    return;
+  }
+
+  if (needed_updates != UPDATE_NONE) {
+    queue_add_callback();
+    return;
+  }
+  for (i = 0; i < TILE_UPDATE_COUNT; i++) {
+    if (tile_updates[i] != NULL) {
+      queue_add_callback();
+      return;
+    }
+  }
+}
+
 /************************************************************************//**
   See comment for queue_mapview_update().
 ****************************************************************************/
@@ -3059,6 +3431,12 @@ void unqueue_mapview_updates(bool write_to_screen)
   for (i = 0; i < TILE_UPDATE_COUNT; i++) {
     my_tile_updates[i] = tile_updates[i];
     tile_updates[i] = NULL;
+    if (my_tile_updates[i] != NULL
+        && tile_updates_queued_size == MAP_INDEX_SIZE) {
+      tile_list_iterate(my_tile_updates[i], ptile) {
+        tile_updates_queued[tile_index(ptile)] &= ~(1 << i);
+      } tile_list_iterate_end;
+    }
   }
 
   if (!map_is_empty()) {
@@ -3253,6 +3631,8 @@ void mapdeco_init(void)
 
   mapdeco_free();
   mapdeco_highlight_table = tile_hash_new();
+  tile_cache_resize();
+  tile_cache_flush();
   mapdeco_crosshair_table = tile_hash_new();
   mapdeco_gotoline_table = gotoline_hash_new();
 }
@@ -3274,6 +3654,11 @@ void mapdeco_free(void)
     gotoline_hash_destroy(mapdeco_gotoline_table);
     mapdeco_gotoline_table = NULL;
   }
+  if (tile_updates_queued != NULL) {
+    free(tile_updates_queued);
+    tile_updates_queued = NULL;
+    tile_updates_queued_size = 0;
+  }
 }
 
 /************************************************************************//**
@@ -3614,6 +3999,9 @@ bool map_canvas_resized(int width, int height)
   }
 
   mapview.can_do_cached_drawing = can_do_cached_drawing();
+  if (tile_cache.num_tiles > 0) {
+    tile_cache_resize();
+  }
 
   return redrawn;
 }
@@ -3634,6 +4022,7 @@ void free_mapcanvas_and_overview(void)
 {
   canvas_free(mapview.store);
   canvas_free(mapview.tmp_store);
+  tile_cache_free();
 }
 
 /************************************************************************//**
@@ -245,6 +245,7 @@ void refresh_city_mapcanvas(struct city *pcity, struct tile *ptile,
 			    bool full_refresh, bool write_to_screen);
 
 void unqueue_mapview_updates(bool write_to_screen);
+void mapview_updates_thaw(void);
 
 void map_to_gui_vector(const struct tileset *t, float zoom,
 		       float *gui_dx, float *gui_dy, int map_dx, int map_dy);
@@ -301,6 +302,7 @@ void put_drawn_sprites(struct canvas *pcanvas, float zoom,
 
 void update_map_canvas(int canvas_x, int canvas_y, int width, int height);
 void update_map_canvas_visible(void);
+void tile_cache_flush(void);
 void update_city_description(struct city *pcity);
 void update_tile_label(struct tile *ptile);
 
@@ -16,9 +16,11 @@
 #endif
 
 #include <math.h> /* floor */
+#include <string.h> /* memset */
 
 /* utility */
 #include "log.h"
+#include "mem.h"
 
 /* client */
 #include "client_main.h" /* can_client_change_view() */
@@ -48,6 +50,19 @@ struct overview overview = {
  */
 static bool overview_dirty = FALSE;
 
+/*
+ * What was last drawn for each tile into the backing store, so that
+ * tiles that have not changed are not drawn again.  A NULL color means
+ * the tile has not been drawn yet.
+ */
+struct overview_tile {
+  struct color *color;
+  bool fogged;
+};
+
+static struct overview_tile *overview_tiles = NULL;
+static int overview_tiles_size = 0;
+
 /************************************************************************//**
   Translate from gui to natural coordinate systems.  This provides natural
   coordinates as a floating-point value so there is no loss of information
@@ -390,26 +405,71 @@ void refresh_overview_canvas(void)
   sometimes a tile may cover more than one rectangle.
 ****************************************************************************/
 static void put_overview_tile_area(struct canvas *pcanvas,
-                                   struct tile *ptile,
+                                   const struct overview_tile *ovtile,
                                    int x, int y, int w, int h)
 {
-  canvas_put_rectangle(pcanvas,
-                       overview_tile_color(ptile),
-                       x, y, w, h);
-  if (gui_options.overview.fog
-      && TILE_KNOWN_UNSEEN == client_tile_get_known(ptile)) {
+  canvas_put_rectangle(pcanvas, ovtile->color, x, y, w, h);
+  if (ovtile->fogged) {
     canvas_put_sprite(pcanvas, x, y, get_basic_fog_sprite(tileset),
                       0, 0, w, h);
   }
 }
 
+/************************************************************************//**
+  Forget what has been drawn into the overview backing store, so that
+  every tile gets drawn again on next refresh.  Must be called when the
+  colors used may have been reallocated.
+****************************************************************************/
+void overview_colors_flush(void)
+{
+  if (overview_tiles != NULL) {
+    memset(overview_tiles, 0, overview_tiles_size * sizeof(*overview_tiles));
+  }
+}
+
+/************************************************************************//**
+  Update the remembered look of the tile. Returns FALSE if the tile looks
+  just like it was last drawn.
+****************************************************************************/
+static bool overview_tile_changed(struct tile *ptile,
+                                  struct overview_tile **ovtile)
+{
+  struct color *pcolor = overview_tile_color(ptile);
+  bool fogged = (gui_options.overview.fog
+                 && TILE_KNOWN_UNSEEN == client_tile_get_known(ptile));
+  struct overview_tile *pot;
+
+  if (overview_tiles_size != MAP_INDEX_SIZE) {
+    free(overview_tiles);
+    overview_tiles_size = MAP_INDEX_SIZE;
+    overview_tiles = fc_calloc(overview_tiles_size, sizeof(*overview_tiles));
+  }
+
+  pot = overview_tiles + tile_index(ptile);
+  *ovtile = pot;
+
+  if (pot->color == pcolor && pot->fogged == fogged) {
+    return FALSE;
+  }
+
+  pot->color = pcolor;
+  pot->fogged = fogged;
+
+  return TRUE;
+}
+
 /************************************************************************//**
   Redraw the given map position in the overview canvas.
 ****************************************************************************/
 void overview_update_tile(struct tile *ptile)
 {
+  struct overview_tile *ovtile;
   int tile_x, tile_y;
 
+  if (!overview_tile_changed(ptile, &ovtile)) {
+    return;
+  }
+
   /* Base overview positions are just like natural positions, but scaled to
    * the overview tile dimensions. */
   index_to_map_pos(&tile_x, &tile_y, tile_index(ptile));
@@ -422,7 +482,7 @@ void overview_update_tile(struct tile *ptile)
         if (overview_x > gui_options.overview.width - OVERVIEW_TILE_WIDTH) {
           /* This tile is shown half on the left and half on the right
            * side of the overview.  So we have to draw it in two parts. */
-          put_overview_tile_area(gui_options.overview.map, ptile,
+          put_overview_tile_area(gui_options.overview.map, ovtile,
                                  overview_x - gui_options.overview.width,
                                  overview_y,
                                  OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
@@ -434,7 +494,7 @@ void overview_update_tile(struct tile *ptile)
       }
     }
 
-    put_overview_tile_area(gui_options.overview.map, ptile,
+    put_overview_tile_area(gui_options.overview.map, ovtile,
                            overview_x, overview_y,
                            OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
 
@@ -491,6 +551,7 @@ void calculate_overview_dimensions(void)
                        get_color(tileset, COLOR_OVERVIEW_UNKNOWN),
                        0, 0,
                        gui_options.overview.width, gui_options.overview.height);
+  overview_colors_flush();
   update_map_canvas_scrollbars_size();
 
   /* Call gui specific function. */
@@ -514,6 +575,11 @@ void overview_free(void)
     gui_options.overview.map = NULL;
     gui_options.overview.window = NULL;
   }
+  if (overview_tiles != NULL) {
+    free(overview_tiles);
+    overview_tiles = NULL;
+    overview_tiles_size = 0;
+  }
 }
 
 /************************************************************************//**
@@ -524,5 +590,6 @@ void overview_redraw_callback(struct option *option)
   /* This is called once for each option changed so it is slower than
    * necessary.  If this becomes a problem it could be switched to use a
    * queue system like the mapview drawing code does. */
+  overview_colors_flush();
   refresh_overview_canvas();
 }
@@ -3022,12 +3022,14 @@ void handle_tile_info(const struct packet_tile_info *packet)
 	free(ptile->spec_sprite);
       }
       ptile->spec_sprite = fc_strdup(packet->spec_sprite);
+      tileset_tile_spec_sprite_changed(tileset, ptile);
       tile_changed = TRUE;
     }
   } else {
     if (ptile->spec_sprite) {
       free(ptile->spec_sprite);
       ptile->spec_sprite = NULL;
+      tileset_tile_spec_sprite_changed(tileset, ptile);
       tile_changed = TRUE;
     }
   }
@@ -3566,6 +3568,7 @@ void handle_ruleset_tech(const struct packet_ruleset_tech *p)
             == p->research_reqs_count);
 
   a->require[AR_ROOT] = advance_by_number(p->root_req);
+  advance_req_closures_invalidate();
 
   a->flags = p->flags;
   a->cost = p->cost;
@@ -5035,6 +5038,9 @@ void handle_freeze_client(void)
 {
   log_debug("handle_freeze_client");
 
+  /* A burst of info packets follows. Let the handlers only record what
+   * needs to be redrawn, and do it all in one pass at thaw. */
+  update_queue_freeze();
   agents_freeze_hint();
 }
 
@@ -5046,6 +5052,10 @@ void handle_thaw_client(void)
   log_debug("handle_thaw_client");
 
   agents_thaw_hint();
+  if (update_queue_is_frozen()) {
+    update_queue_thaw();
+    mapview_updates_thaw();
+  }
   update_turn_done_button_state();
 }
 
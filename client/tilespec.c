@@ -71,7 +71,9 @@
 #include "editor.h"
 #include "goto.h"
 #include "helpdata.h"
+#include "mapview_common.h"     /* for tile_cache_flush() */
 #include "options.h"		/* for fill_xxx */
+#include "overview_common.h"    /* for overview_colors_flush() */
 #include "themes_common.h"
 
 #include "tilespec.h"
@@ -419,6 +421,9 @@ struct small_sprite {
   int hot_x, hot_y;
 
   struct sprite *sprite;
+
+  /* Has a reference been taken for drawing tile special sprites. */
+  bool tile_spec_ref;
 };
 
 /* 'struct small_sprite_list' and related functions. */
@@ -526,6 +531,11 @@ struct tileset {
 
   struct named_sprites sprites;
 
+  /* Special sprite of each map tile, resolved from ptile->spec_sprite
+   * on first use so that drawing needs no tag lookup. */
+  struct sprite **tile_spec_sprites;
+  int num_tile_spec_sprites;
+
   struct color_system *color_system;
 
   struct extra_type_list *style_lists[ESTYLE_COUNT];
@@ -1213,6 +1223,7 @@ void tileset_free(struct tileset *t)
 {
   int i;
 
+  overview_colors_flush();
   tileset_free_tiles(t);
   tileset_free_toplevel(t);
   for (i = 0; i < ARRAY_SIZE(t->sprites.player); i++) {
@@ -3580,6 +3591,8 @@ void tileset_setup_extra(struct tileset *t,
   const int id = extra_index(pextra);
   enum extrastyle_id extrastyle;
 
+  tile_cache_flush();
+
   if (!fc_strcasecmp(pextra->graphic_str, "none")) {
     /* Extra without graphics */
     t->sprites.extras[id].extrastyle = extrastyle_id_invalid();
@@ -3852,6 +3865,8 @@ void tileset_setup_tile_type(struct tileset *t,
   char buffer[MAX_LEN_NAME + 20];
   int i, l;
 
+  tile_cache_flush();
+
   if (!drawing_hash_lookup(t->tile_hash, pterrain->graphic_str, &draw)
       && !drawing_hash_lookup(t->tile_hash, pterrain->graphic_alt, &draw)) {
     tileset_error(LOG_FATAL, _("Terrain \"%s\": no graphic tile \"%s\" or \"%s\"."),
@@ -5101,6 +5116,91 @@ static int fill_terrain_sprite_darkness(struct tileset *t,
   return sprs - saved_sprs;
 }
 
+/************************************************************************//**
+  Return the sprite for a tile special sprite tag, loading it if needed.
+  Each tag is referenced only once, however many tiles use it.
+****************************************************************************/
+static struct sprite *tileset_spec_sprite_get(struct tileset *t,
+                                              const char *tag_name)
+{
+  struct small_sprite *ss;
+
+  if (!sprite_hash_lookup(t->sprite_hash, tag_name, &ss)) {
+    return NULL;
+  }
+
+  if (!ss->tile_spec_ref) {
+    if (load_sprite(t, tag_name, TRUE, FALSE) == NULL) {
+      return NULL;
+    }
+    ss->tile_spec_ref = TRUE;
+  }
+
+  return ss->sprite;
+}
+
+/************************************************************************//**
+  Make sure table of resolved tile special sprites matches current map.
+****************************************************************************/
+static bool tileset_tile_spec_sprites_alloc(struct tileset *t)
+{
+  if (map_is_empty()) {
+    return FALSE;
+  }
+
+  if (t->num_tile_spec_sprites != MAP_INDEX_SIZE) {
+    if (t->tile_spec_sprites != NULL) {
+      free(t->tile_spec_sprites);
+    }
+    t->num_tile_spec_sprites = MAP_INDEX_SIZE;
+    t->tile_spec_sprites = fc_calloc(t->num_tile_spec_sprites,
+                                     sizeof(*t->tile_spec_sprites));
+  }
+
+  return TRUE;
+}
+
+/************************************************************************//**
+  Special sprite of the tile has changed. Resolve it again.
+****************************************************************************/
+void tileset_tile_spec_sprite_changed(struct tileset *t,
+                                      const struct tile *ptile)
+{
+  if (tileset_tile_spec_sprites_alloc(t)) {
+    t->tile_spec_sprites[tile_index(ptile)]
+      = (ptile->spec_sprite != NULL
+         ? tileset_spec_sprite_get(t, ptile->spec_sprite) : NULL);
+  }
+}
+
+/************************************************************************//**
+  Return special sprite of the tile, or NULL if it has none.
+****************************************************************************/
+static struct sprite *tileset_tile_spec_sprite(struct tileset *t,
+                                               const struct tile *ptile)
+{
+  struct sprite *sprite;
+
+  if (ptile->spec_sprite == NULL) {
+    return NULL;
+  }
+
+  if (t->tile_spec_sprites != NULL
+      && tile_index(ptile) < t->num_tile_spec_sprites
+      && t->tile_spec_sprites[tile_index(ptile)] != NULL) {
+    return t->tile_spec_sprites[tile_index(ptile)];
+  }
+
+  /* Not resolved yet, e.g., tileset was changed after
+   * the tile info arrived. */
+  sprite = tileset_spec_sprite_get(t, ptile->spec_sprite);
+  if (sprite != NULL && tileset_tile_spec_sprites_alloc(t)) {
+    t->tile_spec_sprites[tile_index(ptile)] = sprite;
+  }
+
+  return sprite;
+}
+
 /************************************************************************//**
   Add sprites for the base tile to the sprite list.  This doesn't
   include specials or rivers.
@@ -5121,10 +5221,7 @@ static int fill_terrain_sprite_layer(struct tileset *t,
   fc_assert(layer_num < TERRAIN_LAYER_COUNT);
 
   /* Skip the normal drawing process. */
-  /* FIXME: this should avoid calling load_sprite since it's slow and
-   * increases the refcount without limit. */
-  if (ptile->spec_sprite && (sprite = load_sprite(t, ptile->spec_sprite,
-                                                  TRUE, FALSE))) {
+  if ((sprite = tileset_tile_spec_sprite(t, ptile))) {
     if (l == 0) {
       ADD_SPRITE_SIMPLE(sprite);
       return 1;
@@ -6144,6 +6241,7 @@ static void unload_all_sprites(struct tileset *t)
       while (ss->ref_count > 0) {
         unload_sprite(t, tag_name);
       }
+      ss->tile_spec_ref = FALSE;
     } sprite_hash_iterate_end;
   }
 }
@@ -6157,6 +6255,13 @@ void tileset_free_tiles(struct tileset *t)
 
   log_debug("tileset_free_tiles()");
 
+  /* Mapview must not draw any of these from its cache any more. */
+  tile_cache_flush();
+  if (t->tile_spec_sprites != NULL) {
+    free(t->tile_spec_sprites);
+    t->tile_spec_sprites = NULL;
+    t->num_tile_spec_sprites = 0;
+  }
   unload_all_sprites(t);
 
   free_city_sprite(t->sprites.city.tile);
@@ -6878,6 +6983,8 @@ void tileset_player_init(struct tileset *t, struct player *pplayer)
 
   /* Free all data before recreating it. */
   tileset_player_free(t, plrid);
+  /* Player color may have been reallocated. */
+  overview_colors_flush();
 
   if (player_has_color(t, pplayer)) {
     t->sprites.player[plrid].color = color
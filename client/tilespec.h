@@ -236,6 +236,8 @@ void tileset_setup_tech_type(struct tileset *t,
 			     struct advance *padvance);
 void tileset_setup_tile_type(struct tileset *t,
 			     const struct terrain *pterrain);
+void tileset_tile_spec_sprite_changed(struct tileset *t,
+                                      const struct tile *ptile);
 void tileset_setup_resource(struct tileset *t,
 			    const struct resource_type *presource);
 void tileset_setup_extra(struct tileset *t,
@@ -323,6 +323,31 @@ static int one_city_trade_benefit(const struct city *pcity,
   return newtrade - losttrade;
 }
 
+/************************************************************************//**
+  What establishing any trade route costs or brings the source city of a
+  search, apart from the trade of the new route itself. Searches rate
+  many destinations for the same source, so this is computed once.
+****************************************************************************/
+struct caravan_src_info {
+  const struct city *src;
+  int max_routes;     /* max_trade_routes(src) */
+  int benefit;        /* one_city_trade_benefit(src, ..., 0) */
+};
+
+/************************************************************************//**
+  Fill the source city information for a search from src.
+****************************************************************************/
+static void caravan_src_info_init(struct caravan_src_info *info,
+                                  const struct city *src,
+                                  const struct caravan_parameter *param)
+{
+  info->src = src;
+  info->max_routes = max_trade_routes(src);
+  info->benefit = one_city_trade_benefit(src, city_owner(src),
+                                         param->account_for_broken_routes,
+                                         0);
+}
+
 /************************************************************************//**
   Compute one_trade_benefit for both cities and do some other logic.
   This yields the total benefit in terms of trade per turn of establishing
@@ -331,7 +356,8 @@ static int one_city_trade_benefit(const struct city *pcity,
 static double trade_benefit(const struct player *caravan_owner,
                             const struct city *src,
                             const struct city *dest,
-                            const struct caravan_parameter *param)
+                            const struct caravan_parameter *param,
+                            const struct caravan_src_info *src_info)
 {
   /* do we care about trade at all? */
   if (!param->consider_trade) {
@@ -342,7 +368,11 @@ static double trade_benefit(const struct player *caravan_owner,
   if (!can_cities_trade(src, dest) || !can_establish_trade_route(src, dest)) {
     return 0;
   }
-  if (max_trade_routes(src) <= 0 || max_trade_routes(dest) <= 0) {
+  if (src_info != NULL && src_info->src != src) {
+    src_info = NULL;
+  }
+  if ((src_info != NULL ? src_info->max_routes : max_trade_routes(src)) <= 0
+      || max_trade_routes(dest) <= 0) {
     /* Can't create new traderoutes even by replacing old ones if
      * there's no slots at all. */
     return 0;
@@ -351,8 +381,17 @@ static double trade_benefit(const struct player *caravan_owner,
   if (!param->convert_trade) {
     bool countloser = param->account_for_broken_routes;
     int newtrade = trade_base_between_cities(src, dest);
+    int src_benefit;
+
+    if (src_info != NULL && city_owner(src) == caravan_owner) {
+      /* The owner gets the new trade on top of the fixed part. */
+      src_benefit = newtrade + src_info->benefit;
+    } else {
+      src_benefit = one_city_trade_benefit(src, caravan_owner, countloser,
+                                           newtrade);
+    }
 
-    return one_city_trade_benefit(src, caravan_owner, countloser, newtrade)
+    return src_benefit
          + one_city_trade_benefit(dest, caravan_owner, countloser, newtrade);
   } else {
     /* Always fails. */
@@ -457,9 +496,11 @@ static bool does_foreign_trade_param_allow(const struct caravan_parameter *param
   by the src, dest, and arrival_time fields of the result:  Fills in
   the value and help_wonder fields.
   Assumes the owner of src is the owner of the caravan.
+  src_info may be NULL; it is used only if it is about the same src.
 ****************************************************************************/
 static bool get_discounted_reward(const struct unit *caravan,
                                   const struct caravan_parameter *parameter,
+                                  const struct caravan_src_info *src_info,
                                   struct caravan_result *result)
 {
   double trade;
@@ -504,8 +545,6 @@ static bool get_discounted_reward(const struct unit *caravan,
     return FALSE;
   }
 
-  trade = trade_benefit(pplayer_src, src, dest, parameter);
-  windfall = windfall_benefit(caravan, src, dest, parameter);
   if (consider_wonder) {
     wonder = wonder_benefit(caravan, arrival_time, dest, parameter);
     /* we want to aid for wonder building */
@@ -517,6 +556,7 @@ static bool get_discounted_reward(const struct unit *caravan,
   }
 
   if (consider_trade) {
+    trade = trade_benefit(pplayer_src, src, dest, parameter, src_info);
     if (parameter->horizon == FC_INFINITY) {
       trade = perpetuity(trade, discount);
     } else {
@@ -528,6 +568,7 @@ static bool get_discounted_reward(const struct unit *caravan,
   }
 
   if (consider_windfall) {
+    windfall = windfall_benefit(caravan, src, dest, parameter);
     windfall = presentvalue(windfall, arrival_time, discount);
   } else {
     windfall = 0.0;
@@ -567,7 +608,7 @@ static void caravan_evaluate_notransit(const struct unit *caravan,
   const struct city *src = game_city_by_number(caravan->homecity);
 
   caravan_result_init(result, src, dest, 0);
-  get_discounted_reward(caravan, param, result);
+  get_discounted_reward(caravan, param, NULL, result);
 }
 
 /************************************************************************//**
@@ -589,7 +630,7 @@ static bool cewt_callback(void *vdata, const struct city *dest,
 
   if (dest == data->result->dest) {
     data->result->arrival_time = arrival_time;
-    get_discounted_reward(data->caravan, data->param, data->result);
+    get_discounted_reward(data->caravan, data->param, NULL, data->result);
     return TRUE;
   } else {
     return FALSE;
@@ -642,15 +683,17 @@ static void caravan_find_best_destination_notransit(const struct unit *caravan,
   struct caravan_result current;
   struct city *pcity = game_city_by_number(caravan->homecity);
   struct player *src_owner = city_owner(pcity);
+  struct caravan_src_info src_info;
 
   caravan_result_init(best, pcity, NULL, 0);
   current = *best;
+  caravan_src_info_init(&src_info, pcity, param);
 
   players_iterate(dest_owner) {
     if (does_foreign_trade_param_allow(param, src_owner, dest_owner)) {
       city_list_iterate(dest_owner->cities, dest) {
         caravan_result_init(&current, pcity, dest, 0);
-        get_discounted_reward(caravan, param, &current);
+        get_discounted_reward(caravan, param, &src_info, &current);
 
         if (caravan_result_compare(&current, best) > 0) {
           *best = current;
@@ -668,6 +711,7 @@ struct cfbdw_data {
   const struct caravan_parameter *param;
   const struct unit *caravan;
   struct caravan_result *best;
+  struct caravan_src_info src_info;
 };
 
 static bool cfbdw_callback(void *vdata, const struct city *dest,
@@ -678,7 +722,8 @@ static bool cfbdw_callback(void *vdata, const struct city *dest,
 
   caravan_result_init(&current, data->best->src, dest, arrival_time);
 
-  get_discounted_reward(data->caravan, data->param, &current);
+  get_discounted_reward(data->caravan, data->param, &data->src_info,
+                        &current);
   if (caravan_result_compare(&current, data->best) > 0) {
     *data->best = current;
   }
@@ -705,6 +750,7 @@ static void caravan_find_best_destination_withtransit(
   data.caravan = caravan;
   data.best = result;
   caravan_result_init(data.best, src, NULL, 0);
+  caravan_src_info_init(&data.src_info, src, param);
 
   if (src->id != caravan->homecity) {
     start_tile = src->tile;
@@ -750,13 +796,16 @@ static void caravan_optimize_notransit(const struct unit *caravan,
    * home city); iterate over all cities we know about (places the caravan
    * can go to); pick out the best trade route. */
   city_list_iterate(pplayer->cities, src) {
+    struct caravan_src_info src_info;
+
+    caravan_src_info_init(&src_info, src, param);
     players_iterate(dest_owner) {
       if (does_foreign_trade_param_allow(param, pplayer, dest_owner)) {
         city_list_iterate(dest_owner->cities, dest) {
           struct caravan_result current;
 
           caravan_result_init(&current, src, dest, 0);
-          get_discounted_reward(caravan, param, &current);
+          get_discounted_reward(caravan, param, &src_info, &current);
           if (caravan_result_compare(&current, best) > 0) {
             *best = current;
           }
@@ -795,7 +844,7 @@ static bool cowt_callback(void *vdata, const struct city *pcity,
                       pcity, arrival_time);
 
   /* first, see what benefit we'd get from not changing home city */
-  get_discounted_reward(caravan, data->param, &current);
+  get_discounted_reward(caravan, data->param, NULL, &current);
   if (caravan_result_compare(&current, data->best) > 0) {
     *data->best = current;
   }
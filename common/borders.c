@@ -96,7 +96,17 @@ int tile_border_source_strength(struct tile *ptile)
 *************************************************************************/
 int tile_border_strength(struct tile *ptile, struct tile *source)
 {
-  int full_strength = tile_border_source_strength(source);
+  return tile_border_strength_full(ptile, source,
+                                   tile_border_source_strength(source));
+}
+
+/*********************************************************************//**
+  Border source strength at tile, when the full strength of the source,
+  as returned by tile_border_source_strength(), is already known.
+*************************************************************************/
+int tile_border_strength_full(struct tile *ptile, struct tile *source,
+                              int full_strength)
+{
   int sq_dist = sq_map_distance(ptile, source);
 
   if (sq_dist > 0) {
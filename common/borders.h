@@ -23,6 +23,8 @@ bool is_border_source(struct tile *ptile);
 int tile_border_source_radius_sq(struct tile *ptile);
 int tile_border_source_strength(struct tile *ptile);
 int tile_border_strength(struct tile *ptile, struct tile *source);
+int tile_border_strength_full(struct tile *ptile, struct tile *source,
+                              int full_strength);
 
 #ifdef __cplusplus
 }
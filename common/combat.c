@@ -634,26 +634,23 @@ int get_fortified_defense_power(const struct unit *attacker,
                                 TRUE);
 }
 
-/*******************************************************************//**
-A number indicating the defense strength.
-Unlike the one got from win chance this doesn't potentially get insanely
-small if the units are unevenly matched, unlike win_chance.
-***********************************************************************/
-static int get_defense_rating(const struct unit *attacker,
-			      const struct unit *defender)
-{
-  int afp, dfp;
-
-  int rating = get_total_defense_power(attacker, defender);
-  get_modified_firepower(attacker, defender, &afp, &dfp);
-
-  /* How many rounds the defender will last */
-  rating *= (defender->hp + afp-1)/afp;
-
-  rating *= dfp;
-
-  return rating;
-}
+/* Number of distinct defender kinds get_defender() remembers per call. */
+#define DEFENDER_PROFILES 8
+
+/* Combat values of a defender against a given attacker on a given tile.
+ * They only depend on the fields listed first, so units of a stack that
+ * share them - typically most of a big stack - are rated once. */
+struct defender_profile {
+  const struct unit_type *utype;
+  const struct player *owner;
+  int veteran;
+  int hp;
+  bool fortified;
+
+  double win_chance;
+  int unit_def;
+  int defense_rating;
+};
 
 /*******************************************************************//**
   Finds the best defender on the tile, given an attacker.  The diplomatic
@@ -662,9 +659,26 @@ static int get_defense_rating(const struct unit *attacker,
 ***********************************************************************/
 struct unit *get_defender(const struct unit *attacker,
 			  const struct tile *ptile)
+{
+  return get_defender_with_chance(attacker, ptile, NULL);
+}
+
+/*******************************************************************//**
+  Like get_defender(), but also returns in att_chance (if not NULL) the
+  attacker's chance of winning against the chosen defender, as
+  unit_win_chance() would return it. Picking the defender already
+  computes it, so callers wanting both should use this.
+***********************************************************************/
+struct unit *get_defender_with_chance(const struct unit *attacker,
+                                      const struct tile *ptile,
+                                      double *att_chance)
 {
   struct unit *bestdef = NULL;
   int bestvalue = -99, best_cost = 0, rating_of_best = 0;
+  double chance_of_best = 0.0;
+  struct defender_profile profiles[DEFENDER_PROFILES];
+  int num_profiles = 0, next_profile = 0;
+  int att_power = -1;
 
   /* Simply call win_chance with all the possible defenders in turn, and
    * take the best one.  It currently uses build cost as a tiebreaker in
@@ -682,10 +696,65 @@ struct unit *get_defender(const struct unit *attacker,
         && unit_attack_unit_at_tile_result(attacker, defender, ptile) == ATT_OK) {
       bool change = FALSE;
       int build_cost = unit_build_shield_cost_base(defender);
-      int defense_rating = get_defense_rating(attacker, defender);
-      /* This will make units roughly evenly good defenders look alike. */
-      int unit_def 
-        = (int) (100000 * (1 - unit_win_chance(attacker, defender)));
+      const struct unit_type *def_type = unit_type_get(defender);
+      bool fortified = (defender->activity == ACTIVITY_FORTIFIED);
+      struct defender_profile *profile = NULL;
+      int defense_rating;
+      int unit_def;
+      int i;
+
+      for (i = 0; i < num_profiles; i++) {
+        if (profiles[i].utype == def_type
+            && profiles[i].owner == unit_owner(defender)
+            && profiles[i].veteran == defender->veteran
+            && profiles[i].hp == defender->hp
+            && profiles[i].fortified == fortified) {
+          profile = &profiles[i];
+          break;
+        }
+      }
+
+      if (NULL == profile) {
+        int def_power = get_total_defense_power(attacker, defender);
+        int att_fp, def_fp;
+
+        if (0 > att_power) {
+          /* Same for all the defenders, as they are all on ptile. */
+          att_power = get_total_attack_power(attacker, defender);
+        }
+        get_modified_firepower(attacker, defender, &att_fp, &def_fp);
+
+        if (num_profiles < DEFENDER_PROFILES) {
+          profile = &profiles[num_profiles++];
+        } else {
+          /* Mixed stack, recycle the oldest one. */
+          profile = &profiles[next_profile];
+          next_profile = (next_profile + 1) % DEFENDER_PROFILES;
+        }
+
+        profile->utype = def_type;
+        profile->owner = unit_owner(defender);
+        profile->veteran = defender->veteran;
+        profile->hp = defender->hp;
+        profile->fortified = fortified;
+
+        profile->win_chance = win_chance(att_power, attacker->hp, att_fp,
+                                         def_power, defender->hp, def_fp);
+
+        /* This will make units roughly evenly good defenders look alike. */
+        profile->unit_def = (int) (100000 * (1 - profile->win_chance));
+
+        /* A number indicating the defense strength. Unlike the one got
+         * from win chance this doesn't potentially get insanely small if
+         * the units are unevenly matched. It is the defense power times
+         * how many rounds the defender will last times its firepower. */
+        profile->defense_rating = def_power
+                                  * ((defender->hp + att_fp - 1) / att_fp)
+                                  * def_fp;
+      }
+
+      unit_def = profile->unit_def;
+      defense_rating = profile->defense_rating;
 
       fc_assert_action(0 <= unit_def, continue);
 
@@ -713,10 +782,15 @@ struct unit *get_defender(const struct unit *attacker,
 	bestdef = defender;
 	best_cost = build_cost;
 	rating_of_best = defense_rating;
+        chance_of_best = profile->win_chance;
       }
     }
   } unit_list_iterate_end;
 
+  if (att_chance != NULL) {
+    *att_chance = chance_of_best;
+  }
+
   return bestdef;
 }
 
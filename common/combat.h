@@ -77,6 +77,9 @@ int get_total_attack_power(const struct unit *attacker,
 
 struct unit *get_defender(const struct unit *attacker,
 			  const struct tile *ptile);
+struct unit *get_defender_with_chance(const struct unit *attacker,
+                                      const struct tile *ptile,
+                                      double *att_chance);
 struct unit *get_attacker(const struct unit *defender,
 			  const struct tile *ptile);
 
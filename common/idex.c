@@ -15,22 +15,24 @@
    idex = ident index: a lookup table for quick mapping of unit and city
    id values to unit and city pointers.
 
-   Method: use separate hash tables for each type.
+   Method: use separate arrays for each type, indexed directly by id.
+   Ids are small integers handed out (and reused) by the server, so the
+   arrays stay dense: a lookup is a bounds check and a load, and walking
+   the array visits the objects in id order.
    Means code duplication for city/unit cases, but simplicity advantages.
-   Don't have to manage memory at all: store pointers to unit and city
-   structs allocated elsewhere, and keys are pointers to id values inside
-   the structs.
-
-   Note id values should probably be unsigned int: here leave as plain int
-   so can use pointers to pcity->id etc.
+   Don't have to manage memory of the objects at all: store pointers to
+   unit and city structs allocated elsewhere.
 ***********************************************************************/
 
 #ifdef HAVE_CONFIG_H
 #include <fc_config.h>
 #endif
 
+#include <string.h>
+
 /* utility */
 #include "log.h"
+#include "mem.h"
 
 /* common */
 #include "city.h"
@@ -38,25 +40,50 @@
 
 #include "idex.h"
 
+#define IDEX_MIN_SIZE 256
+
+/**********************************************************************//**
+   Return array of pointers grown to have room for given id.
+**************************************************************************/
+static void *idex_grow(void *array, int *psize, int id)
+{
+  int new_size = MAX(*psize * 2, IDEX_MIN_SIZE);
+
+  while (new_size <= id) {
+    new_size *= 2;
+  }
+
+  array = fc_realloc(array, new_size * sizeof(void *));
+  memset((char *) array + *psize * sizeof(void *), 0,
+         (new_size - *psize) * sizeof(void *));
+  *psize = new_size;
+
+  return array;
+}
+
 /**********************************************************************//**
    Initialize.  Should call this at the start before use.
 **************************************************************************/
 void idex_init(struct world *iworld)
 {
-  iworld->cities = city_hash_new();
-  iworld->units = unit_hash_new();
+  iworld->cities = NULL;
+  iworld->cities_size = 0;
+  iworld->units = NULL;
+  iworld->units_size = 0;
 }
 
 /**********************************************************************//**
-   Free the hashs.
+   Free the arrays.
 **************************************************************************/
 void idex_free(struct world *iworld)
 {
-  city_hash_destroy(iworld->cities);
+  free(iworld->cities);
   iworld->cities = NULL;
+  iworld->cities_size = 0;
 
-  unit_hash_destroy(iworld->units);
+  free(iworld->units);
   iworld->units = NULL;
+  iworld->units_size = 0;
 }
 
 /**********************************************************************//**
@@ -67,7 +94,14 @@ void idex_register_city(struct world *iworld, struct city *pcity)
 {
   struct city *old;
 
-  city_hash_replace_full(iworld->cities, pcity->id, pcity, NULL, &old);
+  fc_assert_ret_msg(0 <= pcity->id, "IDEX: invalid city id %d", pcity->id);
+  if (pcity->id >= iworld->cities_size) {
+    iworld->cities = idex_grow(iworld->cities, &iworld->cities_size,
+                               pcity->id);
+  }
+
+  old = iworld->cities[pcity->id];
+  iworld->cities[pcity->id] = pcity;
   fc_assert_ret_msg(NULL == old,
                     "IDEX: city collision: new %d %p %s, old %d %p %s",
                     pcity->id, (void *) pcity, city_name_get(pcity),
@@ -82,7 +116,14 @@ void idex_register_unit(struct world *iworld, struct unit *punit)
 {
   struct unit *old;
 
-  unit_hash_replace_full(iworld->units, punit->id, punit, NULL, &old);
+  fc_assert_ret_msg(0 <= punit->id, "IDEX: invalid unit id %d", punit->id);
+  if (punit->id >= iworld->units_size) {
+    iworld->units = idex_grow(iworld->units, &iworld->units_size,
+                              punit->id);
+  }
+
+  old = iworld->units[punit->id];
+  iworld->units[punit->id] = punit;
   fc_assert_ret_msg(NULL == old,
                     "IDEX: unit collision: new %d %p %s, old %d %p %s",
                     punit->id, (void *) punit, unit_rule_name(punit),
@@ -95,9 +136,8 @@ void idex_register_unit(struct world *iworld, struct unit *punit)
 **************************************************************************/
 void idex_unregister_city(struct world *iworld, struct city *pcity)
 {
-  struct city *old;
+  struct city *old = idex_lookup_city(iworld, pcity->id);
 
-  city_hash_remove_full(iworld->cities, pcity->id, NULL, &old);
   fc_assert_ret_msg(NULL != old,
                     "IDEX: city unreg missing: %d %p %s",
                     pcity->id, (void *) pcity, city_name_get(pcity));
@@ -105,6 +145,7 @@ void idex_unregister_city(struct world *iworld, struct city *pcity)
                     "unreg %d %p %s, old %d %p %s",
                     pcity->id, (void *) pcity, city_name_get(pcity),
                     old->id, (void *) old, city_name_get(old));
+  iworld->cities[pcity->id] = NULL;
 }
 
 /**********************************************************************//**
@@ -113,9 +154,8 @@ void idex_unregister_city(struct world *iworld, struct city *pcity)
 **************************************************************************/
 void idex_unregister_unit(struct world *iworld, struct unit *punit)
 {
-  struct unit *old;
+  struct unit *old = idex_lookup_unit(iworld, punit->id);
 
-  unit_hash_remove_full(iworld->units, punit->id, NULL, &old);
   fc_assert_ret_msg(NULL != old,
                     "IDEX: unit unreg missing: %d %p %s",
                     punit->id, (void *) punit, unit_rule_name(punit));
@@ -123,6 +163,7 @@ void idex_unregister_unit(struct world *iworld, struct unit *punit)
                     "unreg %d %p %s, old %d %p %s",
                     punit->id, (void *) punit, unit_rule_name(punit),
                     old->id, (void*) old, unit_rule_name(old));
+  iworld->units[punit->id] = NULL;
 }
 
 /**********************************************************************//**
@@ -131,11 +172,11 @@ void idex_unregister_unit(struct world *iworld, struct unit *punit)
 **************************************************************************/
 struct city *idex_lookup_city(struct world *iworld, int id)
 {
-  struct city *pcity;
+  if (id < 0 || id >= iworld->cities_size) {
+    return NULL;
+  }
 
-  city_hash_lookup(iworld->cities, id, &pcity);
-
-  return pcity;
+  return iworld->cities[id];
 }
 
 /**********************************************************************//**
@@ -144,9 +185,9 @@ struct city *idex_lookup_city(struct world *iworld, int id)
 **************************************************************************/
 struct unit *idex_lookup_unit(struct world *iworld, int id)
 {
-  struct unit *punit;
-
-  unit_hash_lookup(iworld->units, id, &punit);
+  if (id < 0 || id >= iworld->units_size) {
+    return NULL;
+  }
 
-  return punit;
+  return iworld->units[id];
 }
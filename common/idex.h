@@ -38,6 +38,39 @@ void idex_unregister_unit(struct world *iworld, struct unit *punit);
 struct city *idex_lookup_city(struct world *iworld, int id);
 struct unit *idex_lookup_unit(struct world *iworld, int id);
 
+/* Iterate over all cities registered in the index, in id order. Unlike
+ * the lists of the players, this gives the same order on every run. */
+#define idex_cities_iterate(_iworld, _pcity)                                \
+{                                                                           \
+  int _pcity##_id;                                                          \
+                                                                            \
+  for (_pcity##_id = 0; _pcity##_id < (_iworld)->cities_size;               \
+       _pcity##_id++) {                                                     \
+    struct city *_pcity = (_iworld)->cities[_pcity##_id];                   \
+                                                                            \
+    if (NULL != _pcity) {
+
+#define idex_cities_iterate_end                                             \
+    }                                                                       \
+  }                                                                         \
+}
+
+/* Iterate over all units registered in the index, in id order. */
+#define idex_units_iterate(_iworld, _punit)                                 \
+{                                                                           \
+  int _punit##_id;                                                          \
+                                                                            \
+  for (_punit##_id = 0; _punit##_id < (_iworld)->units_size;                \
+       _punit##_id++) {                                                     \
+    struct unit *_punit = (_iworld)->units[_punit##_id];                    \
+                                                                            \
+    if (NULL != _punit) {
+
+#define idex_units_iterate_end                                              \
+    }                                                                       \
+  }                                                                         \
+}
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -17,6 +17,10 @@
 
 #include <stdarg.h>
 
+#ifdef FREECIV_HAVE_LIBZ
+#include <zlib.h>
+#endif /* FREECIV_HAVE_LIBZ */
+
 #ifdef HAVE_MAPIMG_MAGICKWAND
   #include <wand/MagickWand.h>
 #endif /* HAVE_MAPIMG_MAGICKWAND */
@@ -26,6 +30,7 @@
 #include "bitvector.h"
 #include "fc_cmdline.h"
 #include "fcintl.h"
+#include "fcthread.h"
 #include "log.h"
 #include "mem.h"
 #include "string_vector.h"
@@ -399,7 +404,7 @@ static void img_plot_tile(struct img *pimg, const struct tile *ptile,
                           const struct rgbcolor *pcolor, const bv_pixel pixel);
 static bool img_save(const struct img *pimg, const char *mapimgfile,
                      const char *path);
-static bool img_save_ppm(const struct img *pimg, const char *mapimgfile);
+static bool img_save_builtin(const struct img *pimg, const char *mapimgfile);
 #ifdef HAVE_MAPIMG_MAGICKWAND
 static bool img_save_magickwand(const struct img *pimg,
                                 const char *mapimgfile);
@@ -423,10 +428,16 @@ struct toolkit {
 #define GEN_TOOLKIT(_tool, _format_default, _formats, _save_func, _help)    \
   {_tool, _format_default, _formats, _save_func, _help},
 
+#ifdef FREECIV_HAVE_LIBZ
+#define IMG_BUILTIN_FORMATS (IMGFORMAT_PPM + IMGFORMAT_PNG)
+#else  /* FREECIV_HAVE_LIBZ */
+#define IMG_BUILTIN_FORMATS IMGFORMAT_PPM
+#endif /* FREECIV_HAVE_LIBZ */
+
 static struct toolkit img_toolkits[] = {
-  GEN_TOOLKIT(IMGTOOL_PPM, IMGFORMAT_PPM, IMGFORMAT_PPM,
-              img_save_ppm,
-              N_("Standard ppm files"))
+  GEN_TOOLKIT(IMGTOOL_PPM, IMGFORMAT_PPM, IMG_BUILTIN_FORMATS,
+              img_save_builtin,
+              N_("Standard ppm files and built-in png writer"))
 #ifdef HAVE_MAPIMG_MAGICKWAND
   GEN_TOOLKIT(IMGTOOL_MAGICKWAND, IMGFORMAT_GIF,
               IMGFORMAT_GIF + IMGFORMAT_PNG + IMGFORMAT_PPM + IMGFORMAT_JPG,
@@ -457,6 +468,45 @@ static const struct toolkit *img_toolkit_get(enum imagetool tool);
     }                                                                       \
   }
 
+/* == background writing == */
+
+/* Outcome of writing the image of a job. */
+enum img_job_status {
+  IMG_JOB_WRITTEN,
+  IMG_JOB_COMPRESS_ERROR,
+  IMG_JOB_WRITE_ERROR
+};
+
+/* An image of the built-in toolkit, rendered to plain RGB in the main
+ * thread and written to disk by its own thread so that the caller does
+ * not wait for the file output. The writer thread does not log anything;
+ * it only records the outcome, which the main thread reports. */
+struct img_job {
+  fc_thread thread;
+  bool done;                    /* Protected by mapimg.jobs_mutex */
+  enum img_job_status status;
+  fc_errno error;               /* For IMG_JOB_WRITE_ERROR */
+
+  enum imageformat format;
+  char filename[MAX_LEN_PATH];
+  FILE *fp;                     /* Opened by the main thread */
+  struct astring comment;       /* Lines of text describing the image */
+  int width;
+  int height;
+  unsigned char *rgb;           /* width * height * 3 bytes */
+};
+
+#define SPECLIST_TAG img_job
+#define SPECLIST_TYPE struct img_job
+#include "speclist.h"
+
+#define img_job_list_iterate(img_job_list, pjob) \
+  TYPED_LIST_ITERATE(struct img_job, img_job_list, pjob)
+#define img_job_list_iterate_end \
+  LIST_ITERATE_END
+
+static void img_jobs_reap(bool wait_all, const char *filename);
+
 /* == logging == */
 #define MAX_LEN_ERRORBUF 1024
 
@@ -479,6 +529,10 @@ static struct {
   bool init;
   struct mapdef_list *mapdef;
 
+  /* Images of the built-in toolkit still being written. */
+  struct img_job_list *jobs;
+  fc_mutex jobs_mutex;
+
   mapimg_tile_known_func mapimg_tile_known;
   mapimg_tile_terrain_func mapimg_tile_terrain;
   mapimg_tile_player_func mapimg_tile_owner;
@@ -512,6 +566,8 @@ void mapimg_init(mapimg_tile_known_func mapimg_tile_known,
   }
 
   mapimg.mapdef = mapdef_list_new();
+  mapimg.jobs = img_job_list_new();
+  fc_init_mutex(&mapimg.jobs_mutex);
 
   fc_assert_ret(mapimg_tile_known != NULL);
   mapimg.mapimg_tile_known = mapimg_tile_known;
@@ -560,6 +616,11 @@ void mapimg_free(void)
   mapimg_reset();
   mapdef_list_destroy(mapimg.mapdef);
 
+  /* Let the pending images be written completely. */
+  img_jobs_reap(TRUE, NULL);
+  img_job_list_destroy(mapimg.jobs);
+  fc_destroy_mutex(&mapimg.jobs_mutex);
+
   mapimg.init = FALSE;
 }
 
@@ -934,7 +995,7 @@ static bool mapimg_define_arg(struct mapdef *pmapdef, enum mapdef_arg arg,
             img_toolkit_iterate(toolkit) {
               if ((toolkit->formats & format)) {
                 pmapdef->tool = toolkit->tool;
-                pmapdef->format = toolkit->format_default;
+                pmapdef->format = format;
 
                 error = FALSE;
                 break;
@@ -2277,55 +2338,277 @@ static bool img_save_magickwand(const struct img *pimg,
 #endif /* HAVE_MAPIMG_MAGICKWAND */
 
 /************************************************************************//**
-  Save an image as ppm file (toolkit: ppm).
+  Write the image of a job as (ascii) ppm file.
 ****************************************************************************/
-static bool img_save_ppm(const struct img *pimg, const char *mapimgfile)
+static enum img_job_status img_job_write_ppm(struct img_job *pjob)
 {
-  char ppmname[MAX_LEN_PATH];
-  FILE *fp;
+  FILE *fp = pjob->fp;
+  const char *line, *eol;
+  const unsigned char *px;
+  int i;
+
+  fprintf(fp, "P3\n");
+  for (line = astr_str(&pjob->comment); *line != '\0'; line = eol + 1) {
+    eol = strchr(line, '\n');
+    fprintf(fp, "# %.*s\n", (int) (eol - line), line);
+  }
+
+  fprintf(fp, "%d %d\n", pjob->width, pjob->height);
+  fprintf(fp, "255\n");
+
+  for (i = 0, px = pjob->rgb; i < pjob->width * pjob->height; i++, px += 3) {
+    fprintf(fp, "%d %d %d\n", px[0], px[1], px[2]);
+  }
+
+  return (ferror(fp) ? IMG_JOB_WRITE_ERROR : IMG_JOB_WRITTEN);
+}
+
+#ifdef FREECIV_HAVE_LIBZ
+/************************************************************************//**
+  Write one png chunk; its crc covers the type and the data.
+****************************************************************************/
+static void img_png_chunk(FILE *fp, const char *type,
+                          const unsigned char *data, uLong len)
+{
+  unsigned char head[8];
+  unsigned char tail[4];
+  uLong crc;
+
+  head[0] = (len >> 24) & 0xff;
+  head[1] = (len >> 16) & 0xff;
+  head[2] = (len >> 8) & 0xff;
+  head[3] = len & 0xff;
+  memcpy(head + 4, type, 4);
+
+  crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, head + 4, 4);
+  if (len > 0) {
+    crc = crc32(crc, data, len);
+  }
+  tail[0] = (crc >> 24) & 0xff;
+  tail[1] = (crc >> 16) & 0xff;
+  tail[2] = (crc >> 8) & 0xff;
+  tail[3] = crc & 0xff;
+
+  fwrite(head, 1, sizeof(head), fp);
+  if (len > 0) {
+    fwrite(data, 1, len, fp);
+  }
+  fwrite(tail, 1, sizeof(tail), fp);
+}
+
+/************************************************************************//**
+  Write the image of a job as 24 bit png file, compressed with zlib.
+****************************************************************************/
+static enum img_job_status img_job_write_png(struct img_job *pjob)
+{
+  static const unsigned char signature[8] = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+  };
+  const char keyword[] = "Comment";
+  size_t rowlen = 1 + (size_t) pjob->width * 3;
+  uLong rawlen = rowlen * pjob->height;
+  uLongf zlen = compressBound(rawlen);
+  unsigned char ihdr[13];
+  unsigned char *raw, *zdata, *text;
+  size_t textlen;
+  FILE *fp = pjob->fp;
+  int y;
+
+  /* Each row starts with its filter type, 0 = none. */
+  raw = fc_malloc(rawlen);
+  for (y = 0; y < pjob->height; y++) {
+    raw[y * rowlen] = 0;
+    memcpy(raw + y * rowlen + 1, pjob->rgb + (size_t) y * pjob->width * 3,
+           rowlen - 1);
+  }
+
+  zdata = fc_malloc(zlen);
+  if (compress2(zdata, &zlen, raw, rawlen, Z_DEFAULT_COMPRESSION) != Z_OK) {
+    free(raw);
+    free(zdata);
+    return IMG_JOB_COMPRESS_ERROR;
+  }
+  free(raw);
+
+  ihdr[0] = (pjob->width >> 24) & 0xff;
+  ihdr[1] = (pjob->width >> 16) & 0xff;
+  ihdr[2] = (pjob->width >> 8) & 0xff;
+  ihdr[3] = pjob->width & 0xff;
+  ihdr[4] = (pjob->height >> 24) & 0xff;
+  ihdr[5] = (pjob->height >> 16) & 0xff;
+  ihdr[6] = (pjob->height >> 8) & 0xff;
+  ihdr[7] = pjob->height & 0xff;
+  ihdr[8] = 8;  /* bit depth */
+  ihdr[9] = 2;  /* color type: RGB */
+  ihdr[10] = 0; /* compression: deflate */
+  ihdr[11] = 0; /* filter method */
+  ihdr[12] = 0; /* no interlace */
+
+  /* Keyword, a null separator and the text. */
+  textlen = sizeof(keyword) + astr_len(&pjob->comment);
+  text = fc_malloc(textlen);
+  memcpy(text, keyword, sizeof(keyword));
+  memcpy(text + sizeof(keyword), astr_str(&pjob->comment),
+         astr_len(&pjob->comment));
+
+  fwrite(signature, 1, sizeof(signature), fp);
+  img_png_chunk(fp, "IHDR", ihdr, sizeof(ihdr));
+  img_png_chunk(fp, "tEXt", text, textlen);
+  img_png_chunk(fp, "IDAT", zdata, zlen);
+  img_png_chunk(fp, "IEND", NULL, 0);
+
+  free(text);
+  free(zdata);
+
+  return (ferror(fp) ? IMG_JOB_WRITE_ERROR : IMG_JOB_WRITTEN);
+}
+#endif /* FREECIV_HAVE_LIBZ */
+
+/************************************************************************//**
+  Thread function writing the image of a job.
+****************************************************************************/
+static void img_job_run(void *arg)
+{
+  struct img_job *pjob = (struct img_job *) arg;
+  enum img_job_status status = IMG_JOB_WRITE_ERROR;
+
+  pjob->error = 0;
+  switch (pjob->format) {
+  case IMGFORMAT_PPM:
+    status = img_job_write_ppm(pjob);
+    break;
+#ifdef FREECIV_HAVE_LIBZ
+  case IMGFORMAT_PNG:
+    status = img_job_write_png(pjob);
+    break;
+#endif /* FREECIV_HAVE_LIBZ */
+  default:
+    /* img_save_builtin() accepts only the formats above. */
+    break;
+  }
+
+  if (status == IMG_JOB_WRITE_ERROR) {
+    pjob->error = fc_get_errno();
+  }
+  if (fclose(pjob->fp) != 0 && status == IMG_JOB_WRITTEN) {
+    status = IMG_JOB_WRITE_ERROR;
+    pjob->error = fc_get_errno();
+  }
+  pjob->fp = NULL;
+  pjob->status = status;
+
+  fc_allocate_mutex(&mapimg.jobs_mutex);
+  pjob->done = TRUE;
+  fc_release_mutex(&mapimg.jobs_mutex);
+}
+
+/************************************************************************//**
+  Report the outcome of a finished job and free it. Returns whether the
+  image was written.
+****************************************************************************/
+static bool img_job_finish(struct img_job *pjob)
+{
+  bool ret = FALSE;
+
+  switch (pjob->status) {
+  case IMG_JOB_WRITTEN:
+    log_verbose("Map image saved as '%s'.", pjob->filename);
+    ret = TRUE;
+    break;
+  case IMG_JOB_COMPRESS_ERROR:
+    MAPIMG_LOG(_("could not compress map image: %s"), pjob->filename);
+    log_error(_("Map image: could not compress %s"), pjob->filename);
+    break;
+  case IMG_JOB_WRITE_ERROR:
+    MAPIMG_LOG(_("could not write file: %s"), pjob->filename);
+    log_error(_("Map image: could not write file %s: %s"), pjob->filename,
+              fc_strerror(pjob->error));
+    break;
+  }
+
+  astr_free(&pjob->comment);
+  free(pjob->rgb);
+  free(pjob);
+
+  return ret;
+}
+
+/************************************************************************//**
+  Free the jobs whose image has been written, reporting their outcome.
+  If wait_all is set, wait for all of them, else only for the ones
+  writing to 'filename' (if not NULL).
+****************************************************************************/
+static void img_jobs_reap(bool wait_all, const char *filename)
+{
+  img_job_list_iterate(mapimg.jobs, pjob) {
+    bool done;
+
+    fc_allocate_mutex(&mapimg.jobs_mutex);
+    done = pjob->done;
+    fc_release_mutex(&mapimg.jobs_mutex);
+
+    if (done || wait_all
+        || (filename != NULL && strcmp(pjob->filename, filename) == 0)) {
+      fc_thread_wait(&pjob->thread);
+      img_job_list_remove(mapimg.jobs, pjob);
+      img_job_finish(pjob);
+    }
+  } img_job_list_iterate_end;
+}
+
+/************************************************************************//**
+  Save an image using the built-in toolkit, as ppm or as png file. The
+  image is converted to RGB here; the file itself is written by a
+  separate thread.
+****************************************************************************/
+static bool img_save_builtin(const struct img *pimg, const char *mapimgfile)
+{
+  struct img_job *pjob;
+  unsigned char *px;
   int x, y, xxx, yyy, mindex;
   const struct rgbcolor *pcolor;
 
-  if (pimg->def->format != IMGFORMAT_PPM) {
+  if (!(IMG_BUILTIN_FORMATS & pimg->def->format)) {
     MAPIMG_LOG(_("the ppm toolkit can only create images in the ppm "
-                 "format"));
+                 "or png format"));
     return FALSE;
   }
 
-  if (!img_filename(mapimgfile, IMGFORMAT_PPM, ppmname, sizeof(ppmname))) {
-    MAPIMG_LOG(_("error generating the file name"));
-    return FALSE;
-  }
+  pjob = fc_calloc(1, sizeof(*pjob));
+  pjob->format = pimg->def->format;
 
-  fp = fopen(ppmname, "w");
-  if (!fp) {
-    MAPIMG_LOG(_("could not open file: %s"), ppmname);
+  if (!img_filename(mapimgfile, pjob->format, pjob->filename,
+                    sizeof(pjob->filename))) {
+    MAPIMG_LOG(_("error generating the file name"));
+    free(pjob);
     return FALSE;
   }
 
-  fprintf(fp, "P3\n");
-  fprintf(fp, "# version:2\n");
-  fprintf(fp, "# map definition: %s\n", pimg->def->maparg);
+  astr_init(&pjob->comment);
+  astr_add_line(&pjob->comment, "version:2");
+  astr_add_line(&pjob->comment, "map definition: %s", pimg->def->maparg);
 
   if (pimg->def->colortest) {
-    fprintf(fp, "# color test\n");
+    astr_add_line(&pjob->comment, "color test");
   } else if (BV_ISSET_ANY(pimg->def->player.checked_plrbv)) {
     players_iterate(pplayer) {
       if (!BV_ISSET(pimg->def->player.checked_plrbv, player_index(pplayer))) {
         continue;
       }
 
-      pcolor = imgcolor_player(player_index(pplayer));
-      fprintf(fp, "# %s\n", img_playerstr(pplayer));
+      astr_add_line(&pjob->comment, "%s", img_playerstr(pplayer));
     } players_iterate_end;
   } else {
-    fprintf(fp, "# no players\n");
+    astr_add_line(&pjob->comment, "no players");
   }
+  astr_add(&pjob->comment, "\n");
 
-  fprintf(fp, "%d %d\n", pimg->imgsize.x * pimg->def->zoom,
-          pimg->imgsize.y * pimg->def->zoom);
-  fprintf(fp, "255\n");
+  pjob->width = pimg->imgsize.x * pimg->def->zoom;
+  pjob->height = pimg->imgsize.y * pimg->def->zoom;
+  pjob->rgb = fc_malloc((size_t) pjob->width * pjob->height * 3);
 
+  px = pjob->rgb;
   /* y coordinate */
   for (y = 0; y < pimg->imgsize.y; y++) {
     /* zoom for y */
@@ -2334,20 +2617,44 @@ static bool img_save_ppm(const struct img *pimg, const char *mapimgfile)
       for (x = 0; x < pimg->imgsize.x; x++) {
         mindex = img_index(x, y, pimg);
         pcolor = pimg->map[mindex];
+        if (pcolor == NULL) {
+          pcolor = imgcolor_special(IMGCOLOR_BACKGROUND);
+        }
 
         /* zoom for x */
         for (xxx = 0; xxx < pimg->def->zoom; xxx++) {
-          if (pcolor == NULL) {
-            pcolor = imgcolor_special(IMGCOLOR_BACKGROUND);
-          }
-          fprintf(fp, "%d %d %d\n", pcolor->r, pcolor->g, pcolor->b);
+          *px++ = pcolor->r;
+          *px++ = pcolor->g;
+          *px++ = pcolor->b;
         }
       }
     }
   }
 
-  log_verbose("Map image saved as '%s'.", ppmname);
-  fclose(fp);
+  /* Free what the previous images left behind; an older image with the
+   * same file name must be completely written first. */
+  img_jobs_reap(FALSE, pjob->filename);
+
+  /* Open the file here, so that the caller learns about the most
+   * likely errors right away. */
+  pjob->fp = fc_fopen(pjob->filename,
+                      pjob->format == IMGFORMAT_PPM ? "w" : "wb");
+  if (!pjob->fp) {
+    MAPIMG_LOG(_("could not open file: %s"), pjob->filename);
+    astr_free(&pjob->comment);
+    free(pjob->rgb);
+    free(pjob);
+    return FALSE;
+  }
+
+  img_job_list_append(mapimg.jobs, pjob);
+  if (fc_thread_start(&pjob->thread, img_job_run, pjob) != 0) {
+    /* No thread, write the image right away. */
+    img_job_list_remove(mapimg.jobs, pjob);
+    img_job_run(pjob);
+
+    return img_job_finish(pjob);
+  }
 
   return TRUE;
 }
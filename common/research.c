@@ -521,11 +521,22 @@ void research_update(struct research *presearch)
 {
   enum tech_flag_id flag;
   int techs_researched;
+  /* With TECH_COST_CIV1CIV2 the cost of a tech depends on how many were
+   * researched before it, so required techs have to be summed in
+   * advance_req_iterate() order. Otherwise the cost of each tech is fixed
+   * for this update and computed at most once, in bulbs[]. */
+  bool sequential_cost = (TECH_COST_CIV1CIV2 == game.info.tech_cost_style);
+  int bulbs[A_LAST];
+
+  advance_index_iterate(A_FIRST, i) {
+    bulbs[i] = -1;
+  } advance_index_iterate_end;
 
   advance_index_iterate(A_FIRST, i) {
     enum tech_state state = presearch->inventions[i].state;
     bool root_reqs_known = TRUE;
     bool reachable = research_get_reachable(presearch, i);
+    const bv_techs *closure;
 
     /* Finding if the root reqs of an unreachable tech isn't redundant.
      * A tech can be unreachable via research but have known root reqs
@@ -560,24 +571,46 @@ void research_update(struct research *presearch)
       continue;
     }
 
-    techs_researched = presearch->techs_researched;
-    advance_req_iterate(valid_advance_by_number(i), preq) {
-      Tech_type_id j = advance_number(preq);
+    if (sequential_cost) {
+      techs_researched = presearch->techs_researched;
+      advance_req_iterate(valid_advance_by_number(i), preq) {
+        Tech_type_id j = advance_number(preq);
+
+        if (TECH_KNOWN == research_invention_state(presearch, j)) {
+          continue;
+        }
+
+        BV_SET(presearch->inventions[i].required_techs, j);
+        presearch->inventions[i].num_required_techs++;
+        presearch->inventions[i].bulbs_required +=
+            research_total_bulbs_required(presearch, j, FALSE);
+        /* This is needed to get a correct result for the
+         * research_total_bulbs_required() call when
+         * game.info.game.info.tech_cost_style is TECH_COST_CIV1CIV2. */
+        presearch->techs_researched++;
+      } advance_req_iterate_end;
+      presearch->techs_researched = techs_researched;
+      continue;
+    }
 
-      if (TECH_KNOWN == research_invention_state(presearch, j)) {
+    /* Same set as advance_req_iterate() would visit, minus known techs.
+     * This function never changes which techs are TECH_KNOWN, so it
+     * doesn't matter that later techs aren't updated yet. */
+    closure = advance_req_closure(advance_by_number(i));
+    advance_index_iterate(A_FIRST, j) {
+      if (!BV_ISSET(*closure, j)
+          || TECH_KNOWN == presearch->inventions[j].state) {
         continue;
       }
 
+      if (0 > bulbs[j]) {
+        bulbs[j] = research_total_bulbs_required(presearch, j, FALSE);
+      }
+
       BV_SET(presearch->inventions[i].required_techs, j);
       presearch->inventions[i].num_required_techs++;
-      presearch->inventions[i].bulbs_required +=
-          research_total_bulbs_required(presearch, j, FALSE);
-      /* This is needed to get a correct result for the
-       * research_total_bulbs_required() call when
-       * game.info.game.info.tech_cost_style is TECH_COST_CIV1CIV2. */
-      presearch->techs_researched++;
-    } advance_req_iterate_end;
-    presearch->techs_researched = techs_researched;
+      presearch->inventions[i].bulbs_required += bulbs[j];
+    } advance_index_iterate_end;
   } advance_index_iterate_end;
 
 #ifdef FREECIV_DEBUG
@@ -61,6 +61,11 @@ struct tech_class tech_classes[MAX_NUM_TECH_CLASSES];
 
 static struct user_flag user_tech_flags[MAX_NUM_USER_TECH_FLAGS];
 
+/* For each advance, the set of techs advance_req_iterate() visits.
+ * Built on first use, dropped when the tech tree changes. */
+static bv_techs req_closures[A_LAST];
+static bool req_closures_valid = FALSE;
+
 /**********************************************************************//**
   Return the last item of advances/technologies.
 **************************************************************************/
@@ -220,6 +225,8 @@ void techs_precalc_data(void)
   fc_assert_msg(tech_cost_style_is_valid(game.info.tech_cost_style),
                 "Invalid tech_cost_style %d", game.info.tech_cost_style);
 
+  advance_req_closures_invalidate();
+
   advance_iterate(A_FIRST, padvance) {
     int num_reqs = 0;
     bool min_req = TRUE;
@@ -268,6 +275,43 @@ void techs_precalc_data(void)
   } advance_iterate_end;
 }
 
+/**********************************************************************//**
+  Return the set of techs 'padvance' depends on, recursively and including
+  root_reqs and 'padvance' itself. This is the same set advance_req_iterate()
+  walks, so callers needing only membership can test bits instead.
+**************************************************************************/
+const bv_techs *advance_req_closure(const struct advance *padvance)
+{
+  fc_assert_ret_val(NULL != padvance, NULL);
+
+  if (!req_closures_valid) {
+    advance_index_iterate(A_NONE, i) {
+      BV_CLR_ALL(req_closures[i]);
+    } advance_index_iterate_end;
+
+    advance_iterate(A_FIRST, pgoal) {
+      bv_techs *closure = &req_closures[advance_index(pgoal)];
+
+      advance_req_iterate(pgoal, preq) {
+        BV_SET(*closure, advance_number(preq));
+      } advance_req_iterate_end;
+    } advance_iterate_end;
+
+    req_closures_valid = TRUE;
+  }
+
+  return &req_closures[advance_index(padvance)];
+}
+
+/**********************************************************************//**
+  Forget the cached advance_req_closure() sets. Must be called whenever
+  the requirements of any tech change.
+**************************************************************************/
+void advance_req_closures_invalidate(void)
+{
+  req_closures_valid = FALSE;
+}
+
 /**********************************************************************//**
   Is the given tech a future tech.
 **************************************************************************/
@@ -456,6 +500,7 @@ void techs_init(void)
   int i;
 
   memset(advances, 0, sizeof(advances));
+  advance_req_closures_invalidate();
   for (i = 0; i < ARRAY_SIZE(advances); i++) {
     advances[i].item_number = i;
     advances[i].cost = -1;
@@ -510,6 +555,8 @@ void techs_free(void)
   for (i = 0; i < ARRAY_SIZE(advances); i++) {
     requirement_vector_free(&(advances[i].research_reqs));
   }
+
+  advance_req_closures_invalidate();
 }
 
 /**********************************************************************//**
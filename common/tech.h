@@ -222,6 +222,9 @@ void techs_free(void);
 
 void techs_precalc_data(void);
 
+const bv_techs *advance_req_closure(const struct advance *padvance);
+void advance_req_closures_invalidate(void);
+
 /* Iteration */
 
 /* This iterates over almost all technologies.  It includes non-existent
@@ -117,25 +117,33 @@ struct unit;
 struct unit_list;
 
 struct unit {
+  /* The fields read by nearly every pass over a unit stack or a player's
+   * units (movement, combat, vision, activities) come first, so that they
+   * share the first cache line of the structure. Keep them together and
+   * add rarely used fields further down. */
   struct unit_type *utype; /* Cannot be NULL. */
   struct tile *tile;
-  int refcount;
-  enum direction8 facing;
   struct player *owner; /* Cannot be NULL. */
-  struct player *nationality;
+  struct unit *transporter;   /* This unit is transported by ... */
   int id;
-  int homecity;
-
-  int upkeep[O_LAST]; /* unit upkeep with regards to the homecity */
-
-  int moves_left;
   int hp;
+  int moves_left;
   int veteran;
+  enum unit_activity activity;
   int fuel;
+  int homecity;
 
-  struct tile *goto_tile; /* May be NULL. */
+  bool ai_controlled; /* 0: not automated; 1: automated */
+  bool moved;
 
-  enum unit_activity activity;
+  /* This value is set if the unit is done moving for this turn. This
+   * information is used by the client.  The invariant is:
+   *   - If the unit has no more moves, it's done moving.
+   *   - If the unit is on a goto but is waiting, it's done moving.
+   *   - Otherwise the unit is not done moving. */
+  bool done_moving;
+
+  bool has_orders;
 
   /* The amount of work that has been done on the current activity.  This
    * is counted in turns but is multiplied by ACTIVITY_FACTOR (which allows
@@ -144,26 +152,22 @@ struct unit {
 
   struct extra_type *activity_target;
 
+  struct unit_list *transporting; /* This unit transports ... */
+
+  int refcount;
+  enum direction8 facing;
+  struct player *nationality;
+
+  int upkeep[O_LAST]; /* unit upkeep with regards to the homecity */
+
+  struct tile *goto_tile; /* May be NULL. */
+
   /* Previous activity, so it can be resumed without loss of progress
    * if the user changes their mind during a turn. */
   enum unit_activity changed_from;
   int changed_from_count;
   struct extra_type *changed_from_target;
 
-  bool ai_controlled; /* 0: not automated; 1: automated */
-  bool moved;
-  bool paradropped;
-
-  /* This value is set if the unit is done moving for this turn. This
-   * information is used by the client.  The invariant is:
-   *   - If the unit has no more moves, it's done moving.
-   *   - If the unit is on a goto but is waiting, it's done moving.
-   *   - Otherwise the unit is not done moving. */
-  bool done_moving;
-
-  struct unit *transporter;   /* This unit is transported by ... */
-  struct unit_list *transporting; /* This unit transports ... */
-
   struct goods_type *carrying;
 
   /* The battlegroup ID: defined by the client but stored by the server. */
@@ -171,7 +175,9 @@ struct unit {
 #define BATTLEGROUP_NONE (-1)
   int battlegroup;
 
-  bool has_orders;
+  bool paradropped;
+  bool stay; /* Unit is prohibited from moving */
+
   struct {
     int length, index;
     bool repeat;   /* The path is to be repeated on completion. */
@@ -183,8 +189,6 @@ struct unit {
   enum action_decision action_decision_want;
   struct tile *action_decision_tile;
 
-  bool stay; /* Unit is prohibited from moving */
-
   union {
     struct {
       /* Only used at the client (the server is omniscient; ./client/). */
@@ -209,8 +213,6 @@ struct unit {
     struct {
       /* Only used in the server (./ai/ and ./server/). */
 
-      bool debug;
-
       struct unit_adv *adv;
       void *ais[FREECIV_AI_MOD_LAST];
       int birth_turn;
@@ -225,14 +227,16 @@ struct unit {
       int action_turn;
       struct unit_move_data *moving;
 
-      /* The unit is in the process of dying. */
-      bool dying;
-
       /* Call back to run on unit removal. */
       void (*removal_callback)(struct unit *punit);
 
       /* The upkeep that actually was payed. */
       int upkeep_payed[O_LAST];
+
+      bool debug;
+
+      /* The unit is in the process of dying. */
+      bool dying;
     } server;
   };
 };
@@ -63,6 +63,171 @@ static void adv_dipl_free(const struct player *plr1,
 static struct adv_dipl *adv_dipl_get(const struct player *plr1,
                                      const struct player *plr2);
 
+/* What a player's cities and units threaten, independently of who is
+ * looking at them. Built for every player once at phase start, then each
+ * advisor merges the summaries of the players it considers dangerous. */
+struct adv_threat_summary {
+  bool *continent;      /* Continents with cities of this player. */
+  bool *ocean;          /* Oceans reachable by its seaborne attackers. */
+  bool igwall;
+  bool invasions;
+  bool missile;
+  bool nukes;           /* Has units able to nuke. */
+  bool can_build_nuke;
+};
+
+static struct {
+  bool valid;
+  int num_continents;
+  int num_oceans;
+  struct adv_threat_summary players[MAX_NUM_PLAYER_SLOTS];
+} threat_summaries = { .valid = FALSE };
+
+/**********************************************************************//**
+  Compute what the cities and units of aplayer threaten.
+**************************************************************************/
+static void threat_summary_fill(struct adv_threat_summary *sum,
+                                struct player *aplayer,
+                                int num_continents, int num_oceans,
+                                int nuke_units)
+{
+  int i;
+
+  sum->continent = fc_calloc(num_continents + 1, sizeof(bool));
+  sum->ocean = fc_calloc(num_oceans + 1, sizeof(bool));
+  sum->igwall = FALSE;
+  sum->invasions = FALSE;
+  sum->missile = FALSE;
+  sum->nukes = FALSE;
+  sum->can_build_nuke = FALSE;
+
+  /* The idea is that if there aren't any hostile cities on
+   * our continent, the danger of land attacks is not big
+   * enough to warrant city walls. Concentrate instead on 
+   * coastal fortresses and hunting down enemy transports. */
+  city_list_iterate(aplayer->cities, acity) {
+    Continent_id continent = tile_continent(acity->tile);
+    if (continent >= 0) {
+      sum->continent[continent] = TRUE;
+    }
+  } city_list_iterate_end;
+
+  unit_list_iterate(aplayer->units, punit) {
+    const struct unit_class *pclass = unit_class_get(punit);
+
+    if (unit_type_get(punit)->adv.igwall) {
+      sum->igwall = TRUE;
+    }
+
+    if (pclass->adv.sea_move != MOVE_NONE) {
+      /* If the enemy has not started sailing yet, or we have total
+       * control over the seas, don't worry, keep attacking. */
+      if (uclass_has_flag(pclass, UCF_CAN_OCCUPY_CITY)) {
+        /* Enemy represents a cross-continental threat! */
+        sum->invasions = TRUE;
+      } else if (!sum->invasions && get_transporter_capacity(punit) > 0) {
+        unit_class_iterate(cargoclass) {
+          if (uclass_has_flag(cargoclass, UCF_CAN_OCCUPY_CITY)
+              && can_unit_type_transport(unit_type_get(punit), cargoclass)) {
+            /* Enemy can transport some threatening units! */
+            sum->invasions = TRUE;
+            break;
+          }
+        } unit_class_iterate_end;
+      }
+
+      /* The idea is that while our enemies don't have any offensive
+       * seaborne units, we don't have to worry. Go on the offensive! */
+      if (unit_type_get(punit)->attack_strength > 1) {
+        if (is_ocean_tile(unit_tile(punit))) {
+          Continent_id continent = tile_continent(unit_tile(punit));
+
+          sum->ocean[-continent] = TRUE;
+        } else {
+          adjc_iterate(&(wld.map), unit_tile(punit), tile2) {
+            if (is_ocean_tile(tile2)) {
+              Continent_id continent = tile_continent(tile2);
+
+              sum->ocean[-continent] = TRUE;
+            }
+          } adjc_iterate_end;
+        }
+      }
+      continue;
+    }
+
+    /* If our enemy builds missiles, worry about missile defence. */
+    if (utype_can_do_action(unit_type_get(punit), ACTION_SUICIDE_ATTACK)
+        && unit_type_get(punit)->attack_strength > 1) {
+      sum->missile = TRUE;
+    }
+
+    /* If he builds nukes, worry a lot. */
+    if (unit_can_do_action(punit, ACTION_NUKE)) {
+      sum->nukes = TRUE;
+    }
+  } unit_list_iterate_end;
+
+  /* Check for nuke capability */
+  for (i = 0; i < nuke_units; i++) {
+    struct unit_type *nuke =
+        get_role_unit(action_id_get_role(ACTION_NUKE), i);
+
+    if (can_player_build_unit_direct(aplayer, nuke)) { 
+      sum->can_build_nuke = TRUE;
+      break;
+    }
+  }
+}
+
+/**********************************************************************//**
+  Free the arrays of a threat summary.
+**************************************************************************/
+static void threat_summary_free(struct adv_threat_summary *sum)
+{
+  free(sum->continent);
+  sum->continent = NULL;
+  free(sum->ocean);
+  sum->ocean = NULL;
+}
+
+/**********************************************************************//**
+  Summarize the threats posed by every player in a single pass, so that
+  the adv_data_phase_init() calls of the phase start don't each walk all
+  cities and units of all their enemies.
+**************************************************************************/
+void adv_data_threats_summarize(void)
+{
+  int nuke_units = num_role_units(action_id_get_role(ACTION_NUKE));
+
+  adv_data_threats_forget();
+
+  threat_summaries.num_continents = wld.map.num_continents;
+  threat_summaries.num_oceans = wld.map.num_oceans;
+  players_iterate(aplayer) {
+    threat_summary_fill(&threat_summaries.players[player_index(aplayer)],
+                        aplayer, threat_summaries.num_continents,
+                        threat_summaries.num_oceans, nuke_units);
+  } players_iterate_end;
+  threat_summaries.valid = TRUE;
+}
+
+/**********************************************************************//**
+  Drop the threat summaries; adv_data_phase_init() computes threats
+  directly until the next adv_data_threats_summarize().
+**************************************************************************/
+void adv_data_threats_forget(void)
+{
+  if (!threat_summaries.valid) {
+    return;
+  }
+
+  player_slots_iterate(pslot) {
+    threat_summary_free(&threat_summaries.players[player_slot_index(pslot)]);
+  } player_slots_iterate_end;
+  threat_summaries.valid = FALSE;
+}
+
 /**********************************************************************//**
   Precalculates some important data about the improvements in the game
   that we use later in ai/aicity.c.  We mark improvements as 'calculate'
@@ -284,85 +449,40 @@ bool adv_data_phase_init(struct player *pplayer, bool is_new_phase)
   adv->threats.igwall    = FALSE;
 
   players_iterate(aplayer) {
+    const struct adv_threat_summary *sum;
+    struct adv_threat_summary own;
+
     if (!adv_is_player_dangerous(pplayer, aplayer)) {
       continue;
     }
 
-    /* The idea is that if there aren't any hostile cities on
-     * our continent, the danger of land attacks is not big
-     * enough to warrant city walls. Concentrate instead on 
-     * coastal fortresses and hunting down enemy transports. */
-    city_list_iterate(aplayer->cities, acity) {
-      Continent_id continent = tile_continent(acity->tile);
-      if (continent >= 0) {
-        adv->threats.continent[continent] = TRUE;
-      }
-    } city_list_iterate_end;
-
-    unit_list_iterate(aplayer->units, punit) {
-      const struct unit_class *pclass = unit_class_get(punit);
-
-      if (unit_type_get(punit)->adv.igwall) {
-        adv->threats.igwall = TRUE;
-      }
-
-      if (pclass->adv.sea_move != MOVE_NONE) {
-        /* If the enemy has not started sailing yet, or we have total
-         * control over the seas, don't worry, keep attacking. */
-        if (uclass_has_flag(pclass, UCF_CAN_OCCUPY_CITY)) {
-          /* Enemy represents a cross-continental threat! */
-          adv->threats.invasions = TRUE;
-        } else if (get_transporter_capacity(punit) > 0) {
-          unit_class_iterate(cargoclass) {
-            if (uclass_has_flag(cargoclass, UCF_CAN_OCCUPY_CITY)
-                && can_unit_type_transport(unit_type_get(punit), cargoclass)) {
-              /* Enemy can transport some threatening units! */
-              adv->threats.invasions = TRUE;
-              break;
-            }
-          } unit_class_iterate_end;
-        }
-
-        /* The idea is that while our enemies don't have any offensive
-         * seaborne units, we don't have to worry. Go on the offensive! */
-        if (unit_type_get(punit)->attack_strength > 1) {
-          if (is_ocean_tile(unit_tile(punit))) {
-            Continent_id continent = tile_continent(unit_tile(punit));
-
-            adv->threats.ocean[-continent] = TRUE;
-          } else {
-            adjc_iterate(&(wld.map), unit_tile(punit), tile2) {
-              if (is_ocean_tile(tile2)) {
-                Continent_id continent = tile_continent(tile2);
-
-                adv->threats.ocean[-continent] = TRUE;
-              }
-            } adjc_iterate_end;
-          }
-        }
-        continue;
-      }
-
-      /* If our enemy builds missiles, worry about missile defence. */
-      if (utype_can_do_action(unit_type_get(punit), ACTION_SUICIDE_ATTACK)
-          && unit_type_get(punit)->attack_strength > 1) {
-        adv->threats.missile = TRUE;
-      }
-
-      /* If he builds nukes, worry a lot. */
-      if (unit_can_do_action(punit, ACTION_NUKE)) {
-        danger_of_nukes = TRUE;
-      }
-    } unit_list_iterate_end;
+    if (threat_summaries.valid
+        && threat_summaries.num_continents == adv->num_continents
+        && threat_summaries.num_oceans == adv->num_oceans) {
+      sum = &threat_summaries.players[player_index(aplayer)];
+    } else {
+      /* Outside of the phase start, or the map changed meanwhile. */
+      threat_summary_fill(&own, aplayer, adv->num_continents,
+                          adv->num_oceans, nuke_units);
+      sum = &own;
+    }
 
-    /* Check for nuke capability */
-    for (i = 0; i < nuke_units; i++) {
-      struct unit_type *nuke =
-          get_role_unit(action_id_get_role(ACTION_NUKE), i);
+    for (i = 0; i <= adv->num_continents; i++) {
+      adv->threats.continent[i] |= sum->continent[i];
+    }
+    for (i = 0; i <= adv->num_oceans; i++) {
+      adv->threats.ocean[i] |= sum->ocean[i];
+    }
+    adv->threats.igwall |= sum->igwall;
+    adv->threats.invasions |= sum->invasions;
+    adv->threats.missile |= sum->missile;
+    danger_of_nukes |= sum->nukes;
+    if (sum->can_build_nuke) {
+      adv->threats.nuclear = 1;
+    }
 
-      if (can_player_build_unit_direct(aplayer, nuke)) { 
-        adv->threats.nuclear = 1;
-      }
+    if (sum == &own) {
+      threat_summary_free(&own);
     }
   } players_iterate_end;
 
@@ -138,6 +138,9 @@ void adv_data_init(struct player *pplayer);
 void adv_data_default(struct player *pplayer);
 void adv_data_close(struct player *pplayer);
 
+void adv_data_threats_summarize(void);
+void adv_data_threats_forget(void);
+
 bool adv_data_phase_init(struct player *pplayer, bool is_new_phase);
 void adv_data_phase_done(struct player *pplayer);
 bool is_adv_data_phase_open(struct player *pplayer);
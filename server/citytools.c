@@ -95,7 +95,23 @@ static struct city_list *arrange_workers_queue = NULL;
 /* Suppress sending cities during game_load() and end_phase() */
 static bool send_city_suppressed = FALSE;
 
+/* What a player sees of a city from the outside; see update_dumb_city() */
+struct dumb_city_state {
+  bool occupied;
+  bool walls;
+  bool happy;
+  bool unhappy;
+  int style;
+  int city_image;
+  bv_imprs improvements;
+};
+
 static bool city_workers_queue_remove(struct city *pcity);
+static void dumb_city_state_fill(const struct city *pcity,
+                                 struct dumb_city_state *pstate);
+static bool update_dumb_city_state(struct player *pplayer,
+                                   struct city *pcity,
+                                   const struct dumb_city_state *pstate);
 
 static void announce_trade_route_removal(struct city *pc1, struct city *pc2,
                                          bool source_gone);
@@ -2087,9 +2103,16 @@ static void package_dumb_city(struct player* pplayer, struct tile *ptile,
 ****************************************************************************/
 void refresh_dumb_city(struct city *pcity)
 {
+  struct dumb_city_state state;
+  bool filled = FALSE;
+
   players_iterate(pplayer) {
     if (player_can_see_city_externals(pplayer, pcity)) {
-      if (update_dumb_city(pplayer, pcity)) {
+      if (!filled) {
+        dumb_city_state_fill(pcity, &state);
+        filled = TRUE;
+      }
+      if (update_dumb_city_state(pplayer, pcity, &state)) {
 	struct packet_city_short_info packet;
 
 	if (city_owner(pcity) != pplayer) {
@@ -2121,13 +2144,19 @@ static void broadcast_city_info(struct city *pcity)
   struct packet_city_short_info sc_pack;
   struct player *powner = city_owner(pcity);
   struct traderoute_packet_list *routes = traderoute_packet_list_new();
+  struct dumb_city_state state;
+  bool filled = FALSE;
 
   /* Send to everyone who can see the city. */
   package_city(pcity, &packet, &web_packet, routes, FALSE);
   players_iterate(pplayer) {
     if (can_player_see_city_internals(pplayer, pcity)) {
       if (!send_city_suppressed || pplayer != powner) {
-        update_dumb_city(powner, pcity);
+        if (!filled) {
+          dumb_city_state_fill(pcity, &state);
+          filled = TRUE;
+        }
+        update_dumb_city_state(powner, pcity, &state);
         lsend_packet_city_info(powner->connections, &packet, FALSE);
         web_lsend_packet(city_info_addition, powner->connections, &web_packet, FALSE);
         traderoute_packet_list_iterate(routes, route_packet) {
@@ -2137,7 +2166,11 @@ static void broadcast_city_info(struct city *pcity)
     } else {
       if (player_can_see_city_externals(pplayer, pcity)) {
         reality_check_city(pplayer, pcity->tile);
-	update_dumb_city(pplayer, pcity);
+        if (!filled) {
+          dumb_city_state_fill(pcity, &state);
+          filled = TRUE;
+        }
+        update_dumb_city_state(pplayer, pcity, &state);
 	package_dumb_city(pplayer, pcity->tile, &sc_pack);
 	lsend_packet_city_short_info(pplayer->connections, &sc_pack);
       }
@@ -2509,36 +2542,41 @@ void package_city(struct city *pcity, struct packet_city_info *packet,
 }
 
 /************************************************************************//**
-  Updates a players knowledge about a city. If the player_tile already
-  contains a city it must be the same city (avoid problems by always calling
-  reality_check_city() first)
-
-  Returns TRUE iff anything has changed for the player city (i.e., if the
-  client needs to be updated with a *short* city packet).  This information
-  is only used in refresh_dumb_cities; elsewhere the data is (of necessity)
-  broadcast regardless.
+  Collect what players can see of a city from the outside. This does not
+  depend on the viewing player, so it is done once when several players'
+  knowledge about the city is updated.
 ****************************************************************************/
-bool update_dumb_city(struct player *pplayer, struct city *pcity)
+static void dumb_city_state_fill(const struct city *pcity,
+                                 struct dumb_city_state *pstate)
 {
-  bv_imprs improvements;
-  struct tile *pcenter = city_tile(pcity);
-  struct vision_site *pdcity = map_get_player_city(pcenter, pplayer);
   /* pcity->client.occupied isn't used at the server, so we go straight to the
    * unit list to check the occupied status. */
-  bool occupied = (unit_list_size(pcenter->units) > 0);
-  bool walls = city_got_citywalls(pcity);
-  bool happy = city_happy(pcity);
-  bool unhappy = city_unhappy(pcity);
-  int style = pcity->style;
-  int city_image = get_city_bonus(pcity, EFT_CITY_IMAGE);
-
-  BV_CLR_ALL(improvements);
+  pstate->occupied = (unit_list_size(city_tile(pcity)->units) > 0);
+  pstate->walls = city_got_citywalls(pcity);
+  pstate->happy = city_happy(pcity);
+  pstate->unhappy = city_unhappy(pcity);
+  pstate->style = pcity->style;
+  pstate->city_image = get_city_bonus(pcity, EFT_CITY_IMAGE);
+
+  BV_CLR_ALL(pstate->improvements);
   improvement_iterate(pimprove) {
     if (is_improvement_visible(pimprove)
      && city_has_building(pcity, pimprove)) {
-      BV_SET(improvements, improvement_index(pimprove));
+      BV_SET(pstate->improvements, improvement_index(pimprove));
     }
   } improvement_iterate_end;
+}
+
+/************************************************************************//**
+  Updates a players knowledge about a city from the already collected
+  state of the city. See update_dumb_city().
+****************************************************************************/
+static bool update_dumb_city_state(struct player *pplayer,
+                                   struct city *pcity,
+                                   const struct dumb_city_state *pstate)
+{
+  struct tile *pcenter = city_tile(pcity);
+  struct vision_site *pdcity = map_get_player_city(pcenter, pplayer);
 
   if (NULL == pdcity) {
     pdcity = vision_site_new_from_city(pcity);
@@ -2553,13 +2591,13 @@ bool update_dumb_city(struct player *pplayer, struct city *pcity)
               "at %i,%i for player %s",
               TILE_XY(city_tile(pcity)), player_name(pplayer));
     pdcity->identity = pcity->id;   /* ?? */
-  } else if (pdcity->occupied == occupied
-             && pdcity->walls == walls
-             && pdcity->happy == happy
-             && pdcity->unhappy == unhappy
-             && pdcity->style == style
-             && pdcity->city_image == city_image
-             && BV_ARE_EQUAL(pdcity->improvements, improvements)
+  } else if (pdcity->occupied == pstate->occupied
+             && pdcity->walls == pstate->walls
+             && pdcity->happy == pstate->happy
+             && pdcity->unhappy == pstate->unhappy
+             && pdcity->style == pstate->style
+             && pdcity->city_image == pstate->city_image
+             && BV_ARE_EQUAL(pdcity->improvements, pstate->improvements)
              && vision_site_size_get(pdcity) == city_size_get(pcity)
              && vision_site_owner(pdcity) == city_owner(pcity)
              && 0 == strcmp(pdcity->name, city_name_get(pcity))) {
@@ -2567,17 +2605,36 @@ bool update_dumb_city(struct player *pplayer, struct city *pcity)
   }
 
   vision_site_update_from_city(pdcity, pcity);
-  pdcity->occupied = occupied;
-  pdcity->walls = walls;
-  pdcity->style = style;
-  pdcity->city_image = city_image;
-  pdcity->happy = happy;
-  pdcity->unhappy = unhappy;
-  pdcity->improvements = improvements;
+  pdcity->occupied = pstate->occupied;
+  pdcity->walls = pstate->walls;
+  pdcity->style = pstate->style;
+  pdcity->city_image = pstate->city_image;
+  pdcity->happy = pstate->happy;
+  pdcity->unhappy = pstate->unhappy;
+  pdcity->improvements = pstate->improvements;
 
   return TRUE;
 }
 
+/************************************************************************//**
+  Updates a players knowledge about a city. If the player_tile already
+  contains a city it must be the same city (avoid problems by always calling
+  reality_check_city() first)
+
+  Returns TRUE iff anything has changed for the player city (i.e., if the
+  client needs to be updated with a *short* city packet).  This information
+  is only used in refresh_dumb_cities; elsewhere the data is (of necessity)
+  broadcast regardless.
+****************************************************************************/
+bool update_dumb_city(struct player *pplayer, struct city *pcity)
+{
+  struct dumb_city_state state;
+
+  dumb_city_state_fill(pcity, &state);
+
+  return update_dumb_city_state(pplayer, pcity, &state);
+}
+
 /************************************************************************//**
   Removes outdated (nonexistant) cities from a player
 ****************************************************************************/
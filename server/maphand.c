@@ -60,6 +60,21 @@
 /* Suppress send_tile_info() during game_load() */
 static bool send_tile_suppressed = FALSE;
 
+/* Iterate over the tiles known by a player, in whole_map_iterate() order.
+ * Unknown parts of the map are skipped a byte of the known bitvector at
+ * a time. */
+#define known_tiles_iterate(_pplayer, _tile)                                \
+{                                                                           \
+  int _tile##_index = -1;                                                   \
+                                                                            \
+  while (0 <= (_tile##_index = dbv_next_set(&(_pplayer)->tile_known,        \
+                                            _tile##_index + 1))) {          \
+    struct tile *_tile = index_to_tile(&(wld.map), _tile##_index);
+
+#define known_tiles_iterate_end                                             \
+  }                                                                         \
+}
+
 static void player_tile_init(struct tile *ptile, struct player *pplayer);
 static void player_tile_free(struct tile *ptile, struct player *pplayer);
 static void give_tile_info_from_player_to_player(struct player *pfrom,
@@ -366,9 +381,10 @@ void give_map_from_player_to_player(struct player *pfrom, struct player *pdest)
 {
   buffer_shared_vision(pdest);
 
-  whole_map_iterate(&(wld.map), ptile) {
+  /* Nothing is given from tiles 'pfrom' doesn't know. */
+  known_tiles_iterate(pfrom, ptile) {
     give_tile_info_from_player_to_player(pfrom, pdest, ptile);
-  } whole_map_iterate_end;
+  } known_tiles_iterate_end;
 
   unbuffer_shared_vision(pdest);
   city_thaw_workers_queue();
@@ -382,11 +398,11 @@ void give_seamap_from_player_to_player(struct player *pfrom, struct player *pdes
 {
   buffer_shared_vision(pdest);
 
-  whole_map_iterate(&(wld.map), ptile) {
+  known_tiles_iterate(pfrom, ptile) {
     if (is_ocean_tile(ptile)) {
       give_tile_info_from_player_to_player(pfrom, pdest, ptile);
     }
-  } whole_map_iterate_end;
+  } known_tiles_iterate_end;
 
   unbuffer_shared_vision(pdest);
   city_thaw_workers_queue();
@@ -1471,9 +1487,9 @@ static void really_give_tile_info_from_player_to_player(struct player *pfrom,
 static void really_give_map_from_player_to_player(struct player *pfrom,
                                                   struct player *pdest)
 {
-  whole_map_iterate(&(wld.map), ptile) {
+  known_tiles_iterate(pfrom, ptile) {
     really_give_tile_info_from_player_to_player(pfrom, pdest, ptile);
-  } whole_map_iterate_end;
+  } known_tiles_iterate_end;
 
   city_thaw_workers_queue();
   sync_cities();
@@ -2117,6 +2133,13 @@ void map_update_border(struct tile *ptile, struct player *owner,
 void map_claim_border(struct tile *ptile, struct player *owner,
                       int radius_sq)
 {
+  /* Full strengths of this source and of the last other claimer met.
+   * Neither changes while the border is claimed; neighbouring tiles
+   * mostly share their claimer. */
+  int strength = -1;
+  struct tile *last_claimer = NULL;
+  int last_claimer_strength = 0;
+
   if (BORDERS_DISABLED == game.info.borders) {
     return;
   }
@@ -2173,8 +2196,17 @@ void map_claim_border(struct tile *ptile, struct player *owner,
         }
       }
 
-      strength_old = tile_border_strength(dtile, dclaimer);
-      strength_new = tile_border_strength(dtile, ptile);
+      if (dclaimer != last_claimer) {
+        last_claimer = dclaimer;
+        last_claimer_strength = tile_border_source_strength(dclaimer);
+      }
+      if (strength < 0) {
+        strength = tile_border_source_strength(ptile);
+      }
+
+      strength_old = tile_border_strength_full(dtile, dclaimer,
+                                               last_claimer_strength);
+      strength_new = tile_border_strength_full(dtile, ptile, strength);
 
       if (strength_new <= strength_old) {
         /* Stronger shall prevail,
@@ -1404,7 +1404,7 @@ void server_player_init(struct player *pplayer, bool initmap,
 
   adv_data_default(pplayer);
 
-  /* We don't push this in calc_civ_score(), or it will be reset
+  /* We don't push this in calc_civ_scores(), or it will be reset
    * every turn. */
   pplayer->score.units_built = 0;
   pplayer->score.units_killed = 0;
@@ -23,6 +23,7 @@
 #include "city.h"
 #include "game.h"
 #include "government.h"
+#include "idex.h"
 #include "map.h"
 #include "movement.h"
 #include "player.h"
@@ -389,6 +390,37 @@ static void check_cities(const char *file, const char *function, int line)
   } players_iterate_end;
 }
 
+/**********************************************************************//**
+  Check that the id index holds exactly the cities and units that the
+  players own.
+**************************************************************************/
+static void check_idex(const char *file, const char *function, int line)
+{
+  int ncities = 0, nunits = 0;
+
+  idex_cities_iterate(&wld, pcity) {
+    SANITY_CITY(pcity, idex_lookup_city(&wld, pcity->id) == pcity);
+    SANITY_CITY(pcity, city_list_find_number(city_owner(pcity)->cities,
+                                             pcity->id) == pcity);
+    ncities++;
+  } idex_cities_iterate_end;
+
+  idex_units_iterate(&wld, punit) {
+    SANITY_CHECK(idex_lookup_unit(&wld, punit->id) == punit);
+    SANITY_CHECK(unit_list_find(unit_owner(punit)->units,
+                                punit->id) == punit);
+    nunits++;
+  } idex_units_iterate_end;
+
+  players_iterate(pplayer) {
+    ncities -= city_list_size(pplayer->cities);
+    nunits -= unit_list_size(pplayer->units);
+  } players_iterate_end;
+
+  SANITY_CHECK(ncities == 0);
+  SANITY_CHECK(nunits == 0);
+}
+
 /**********************************************************************//**
   Sanity checks on all units in the world.
 **************************************************************************/
@@ -654,6 +686,7 @@ void real_sanity_check(const char *file, const char *function, int line)
     check_map(file, function, line);
     check_cities(file, function, line);
     check_units(file, function, line);
+    check_idex(file, function, line);
     check_fow(file, function, line);
   }
   check_misc(file, function, line);
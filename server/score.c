@@ -245,14 +245,15 @@ static void get_player_landarea(struct claim_map *pcmap,
 }
 
 /**********************************************************************//**
-  Calculates the civilization score for the player.
+  Calculates the civilization score for the player, taking land and
+  settled areas from the already built claim map.
 **************************************************************************/
-void calc_civ_score(struct player *pplayer)
+static void calc_civ_score(struct player *pplayer,
+                           struct claim_map *pcmap)
 {
   const struct research *presearch;
   struct city *wonder_city;
   int landarea = 0, settledarea = 0;
-  static struct claim_map cmap;
 
   pplayer->score.happy = 0;
   pplayer->score.content = 0;
@@ -302,9 +303,7 @@ void calc_civ_score(struct player *pplayer)
     pplayer->score.literacy += (city_population(pcity) * bonus) / 100;
   } city_list_iterate_end;
 
-  build_landarea_map(&cmap);
-
-  get_player_landarea(&cmap, pplayer, &landarea, &settledarea);
+  get_player_landarea(pcmap, pplayer, &landarea, &settledarea);
   pplayer->score.landarea = landarea;
   pplayer->score.settledarea = settledarea;
 
@@ -335,6 +334,21 @@ void calc_civ_score(struct player *pplayer)
   pplayer->score.game = get_civ_score(pplayer);
 }
 
+/**********************************************************************//**
+  Calculates the civilization score for all players. The claim map only
+  depends on the map and cities, so it is built once for everybody
+  instead of once per player.
+**************************************************************************/
+void calc_civ_scores(void)
+{
+  static struct claim_map cmap;
+
+  build_landarea_map(&cmap);
+  players_iterate(pplayer) {
+    calc_civ_score(pplayer, &cmap);
+  } players_iterate_end;
+}
+
 /**********************************************************************//**
   Return the score given by the units stats.
 **************************************************************************/
@@ -45,6 +45,12 @@
 #include <readline/history.h>
 #include <readline/readline.h>
 #endif
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #ifdef HAVE_SYS_SELECT_H
 #include <sys/select.h>
 #endif
@@ -134,6 +140,341 @@ static void send_lanserver_response(void);
 
 static bool no_input = FALSE;
 
+/* Readiness of the sockets, as found by sniff_wait(). */
+struct sniff_events {
+  bool stdin_read;
+  bool listen_except;           /* On any of the listening sockets */
+  bool *listen_read;            /* listen_count entries */
+  bool conn_read[MAX_NUM_CONNECTIONS];
+  bool conn_write[MAX_NUM_CONNECTIONS];
+  bool conn_except[MAX_NUM_CONNECTIONS];
+};
+
+static struct sniff_events sniff_events;
+
+#if defined(HAVE_SYS_EPOLL_H) || defined(HAVE_POLL_H)
+/*************************************************************************//**
+  Convert timeout to milliseconds for epoll_wait() and poll(). Rounded up,
+  so that a timeout under a millisecond doesn't become a busy loop.
+*****************************************************************************/
+static int timeval_to_msec(const fc_timeval *tv)
+{
+  return tv->tv_sec * 1000 + (tv->tv_usec + 999) / 1000;
+}
+#endif /* HAVE_SYS_EPOLL_H || HAVE_POLL_H */
+
+#ifdef HAVE_SYS_EPOLL_H
+/* The epoll set holds the listening sockets, stdin and the connections
+ * all the time, so that they need not be passed in on every wakeup like
+ * with select(). If it can't be used, we fall back to select(). */
+static int epoll_fd = -1;
+static bool epoll_failed = FALSE;
+static bool epoll_has_stdin = FALSE;
+/* Stdin is e.g. a regular file or /dev/null, which epoll can't watch. */
+static bool epoll_stdin_unpollable = FALSE;
+static uint32_t epoll_conn_events[MAX_NUM_CONNECTIONS];
+static struct epoll_event *epoll_results = NULL;
+static int epoll_results_size = 0;
+
+#define EPOLL_ID_STDIN  MAX_NUM_CONNECTIONS
+#define EPOLL_ID_LISTEN (MAX_NUM_CONNECTIONS + 1)
+
+/*************************************************************************//**
+  Stop using epoll. It's not tried again, select() is used instead.
+*****************************************************************************/
+static void sniff_epoll_close(void)
+{
+  if (epoll_fd != -1) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
+  FC_FREE(epoll_results);
+  epoll_results_size = 0;
+  epoll_has_stdin = FALSE;
+}
+
+/*************************************************************************//**
+  Add, modify or delete socket in the epoll set. Returns FALSE on failure.
+*****************************************************************************/
+static bool sniff_epoll_ctl(int op, int sock, uint32_t events, uint32_t id)
+{
+  struct epoll_event ev;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.u32 = id;
+
+  return 0 == epoll_ctl(epoll_fd, op, sock, &ev);
+}
+
+/*************************************************************************//**
+  Set epoll up with the sockets that are currently open.
+*****************************************************************************/
+static bool sniff_epoll_init(void)
+{
+  int i;
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd == -1) {
+    log_verbose("Cannot use epoll: %s", fc_strerror(fc_get_errno()));
+    return FALSE;
+  }
+
+  for (i = 0; i < listen_count; i++) {
+    if (!sniff_epoll_ctl(EPOLL_CTL_ADD, listen_socks[i],
+                         EPOLLIN | EPOLLPRI, EPOLL_ID_LISTEN + i)) {
+      log_verbose("Cannot use epoll: %s", fc_strerror(fc_get_errno()));
+      sniff_epoll_close();
+      return FALSE;
+    }
+  }
+
+  for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
+    struct connection *pconn = connections + i;
+
+    epoll_conn_events[i] = 0;
+    if (pconn->used) {
+      if (!sniff_epoll_ctl(EPOLL_CTL_ADD, pconn->sock, 0, i)) {
+        log_verbose("Cannot use epoll: %s", fc_strerror(fc_get_errno()));
+        sniff_epoll_close();
+        return FALSE;
+      }
+    }
+  }
+
+  epoll_results_size = MAX_NUM_CONNECTIONS + 1 + listen_count;
+  epoll_results = fc_malloc(epoll_results_size * sizeof(*epoll_results));
+
+  return TRUE;
+}
+
+/*************************************************************************//**
+  New connection has been made.
+*****************************************************************************/
+static void sniff_epoll_add_conn(struct connection *pconn)
+{
+  int id = pconn - connections;
+
+  epoll_conn_events[id] = 0;
+  if (epoll_fd != -1
+      && !sniff_epoll_ctl(EPOLL_CTL_ADD, pconn->sock, 0, id)) {
+    log_error("Cannot add connection to epoll set, using select(): %s",
+              fc_strerror(fc_get_errno()));
+    sniff_epoll_close();
+    epoll_failed = TRUE;
+  }
+}
+
+/*************************************************************************//**
+  Connection is about to be closed.
+*****************************************************************************/
+static void sniff_epoll_remove_conn(struct connection *pconn)
+{
+  if (epoll_fd != -1) {
+    (void) sniff_epoll_ctl(EPOLL_CTL_DEL, pconn->sock, 0, 0);
+  }
+}
+
+/*************************************************************************//**
+  Wait for events with epoll. Returns like select(): -1 on error, 0 on
+  timeout, and the number of ready sockets otherwise.
+*****************************************************************************/
+static int sniff_epoll_wait(struct sniff_events *ev, fc_timeval *tv)
+{
+  int i, nfds, timeout;
+  bool stdin_ready = FALSE;
+
+#ifndef FREECIV_SOCKET_ZERO_NOT_STDIN
+  if (no_input) {
+    if (epoll_has_stdin) {
+      (void) sniff_epoll_ctl(EPOLL_CTL_DEL, 0, 0, 0);
+      epoll_has_stdin = FALSE;
+    }
+  } else if (!epoll_has_stdin && !epoll_stdin_unpollable) {
+    if (sniff_epoll_ctl(EPOLL_CTL_ADD, 0, EPOLLIN, EPOLL_ID_STDIN)) {
+      epoll_has_stdin = TRUE;
+    } else if (fc_get_errno() == EPERM) {
+      epoll_stdin_unpollable = TRUE;
+    } else {
+      return -2;
+    }
+  }
+  /* select() always finds a file that can't be polled readable. Do the
+   * same, reading it will hit the end of file sooner or later. */
+  stdin_ready = (!no_input && epoll_stdin_unpollable);
+#endif /* FREECIV_SOCKET_ZERO_NOT_STDIN */
+
+  /* Only the connections whose wishes changed cost a system call. */
+  for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
+    struct connection *pconn = connections + i;
+    uint32_t events = 0;
+
+    if (!pconn->used) {
+      continue;
+    }
+    if (!pconn->server.is_closing) {
+      events = EPOLLIN | EPOLLPRI;
+      if (0 < pconn->send_buffer->ndata) {
+        events |= EPOLLOUT;
+      }
+    }
+    if (events != epoll_conn_events[i]) {
+      if (!sniff_epoll_ctl(EPOLL_CTL_MOD, pconn->sock, events, i)) {
+        return -2;
+      }
+      epoll_conn_events[i] = events;
+    }
+  }
+
+  timeout = (stdin_ready ? 0 : timeval_to_msec(tv));
+  nfds = epoll_wait(epoll_fd, epoll_results, epoll_results_size, timeout);
+  if (nfds < 0) {
+    return nfds;
+  }
+
+  for (i = 0; i < nfds; i++) {
+    uint32_t id = epoll_results[i].data.u32;
+    uint32_t events = epoll_results[i].events;
+
+    if (id < MAX_NUM_CONNECTIONS) {
+      /* Let reading find out about errors and hangups. */
+      ev->conn_read[id] = (0 != (events & (EPOLLIN | EPOLLERR | EPOLLHUP)));
+      ev->conn_write[id] = (0 != (events & EPOLLOUT));
+      ev->conn_except[id] = (0 != (events & EPOLLPRI));
+    } else if (id == EPOLL_ID_STDIN) {
+      ev->stdin_read = TRUE;
+    } else if (id - EPOLL_ID_LISTEN < listen_count) {
+      ev->listen_read[id - EPOLL_ID_LISTEN] = (0 != (events & EPOLLIN));
+      if (events & EPOLLPRI) {
+        ev->listen_except = TRUE;
+      }
+    }
+  }
+
+  if (stdin_ready) {
+    ev->stdin_read = TRUE;
+    nfds++;
+  }
+
+  return nfds;
+}
+#endif /* HAVE_SYS_EPOLL_H */
+
+/*************************************************************************//**
+  Wait for events with select(). Returns -1 on error, 0 on timeout, and
+  the number of ready sockets otherwise.
+*****************************************************************************/
+static int sniff_select(struct sniff_events *ev, fc_timeval *tv)
+{
+  int i, ret;
+  int max_desc;
+  fd_set readfs, writefs, exceptfs;
+
+  FC_FD_ZERO(&readfs);
+  FC_FD_ZERO(&writefs);
+  FC_FD_ZERO(&exceptfs);
+
+  if (!no_input) {
+#ifdef FREECIV_SOCKET_ZERO_NOT_STDIN
+    fc_init_console();
+#else /* FREECIV_SOCKET_ZERO_NOT_STDIN */
+#   if !defined(__VMS)
+    FD_SET(0, &readfs);
+#   endif /* VMS */
+#endif /* FREECIV_SOCKET_ZERO_NOT_STDIN */
+  }
+
+  max_desc = 0;
+  for (i = 0; i < listen_count; i++) {
+    FD_SET(listen_socks[i], &readfs);
+    FD_SET(listen_socks[i], &exceptfs);
+    max_desc = MAX(max_desc, listen_socks[i]);
+  }
+
+  for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
+    struct connection *pconn = connections + i;
+
+    if (pconn->used && !pconn->server.is_closing) {
+      FD_SET(pconn->sock, &readfs);
+      if (0 < pconn->send_buffer->ndata) {
+        FD_SET(pconn->sock, &writefs);
+      }
+      FD_SET(pconn->sock, &exceptfs);
+      max_desc = MAX(pconn->sock, max_desc);
+    }
+  }
+
+  ret = fc_select(max_desc + 1, &readfs, &writefs, &exceptfs, tv);
+  if (ret <= 0) {
+    return ret;
+  }
+
+#ifndef FREECIV_SOCKET_ZERO_NOT_STDIN
+  ev->stdin_read = (!no_input && FD_ISSET(0, &readfs));
+#endif /* FREECIV_SOCKET_ZERO_NOT_STDIN */
+
+  for (i = 0; i < listen_count; i++) {
+    ev->listen_read[i] = FD_ISSET(listen_socks[i], &readfs);
+    if (FD_ISSET(listen_socks[i], &exceptfs)) {
+      ev->listen_except = TRUE;
+    }
+  }
+
+  for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
+    struct connection *pconn = connections + i;
+
+    if (pconn->used && !pconn->server.is_closing) {
+      ev->conn_read[i] = FD_ISSET(pconn->sock, &readfs);
+      ev->conn_write[i] = FD_ISSET(pconn->sock, &writefs);
+      ev->conn_except[i] = FD_ISSET(pconn->sock, &exceptfs);
+    }
+  }
+
+  return ret;
+}
+
+/*************************************************************************//**
+  Wait for up to 'tv' for input on the listening sockets, the connections
+  and stdin, and for the connections with data to send to become writable.
+  The result is stored to 'ev'. Returns -1 on error, 0 on timeout, and
+  a positive number otherwise.
+*****************************************************************************/
+static int sniff_wait(struct sniff_events *ev, fc_timeval *tv)
+{
+  if (ev->listen_read == NULL) {
+    ev->listen_read = fc_calloc(MAX(listen_count, 1),
+                                sizeof(*ev->listen_read));
+  }
+
+  ev->stdin_read = FALSE;
+  ev->listen_except = FALSE;
+  memset(ev->listen_read, 0, listen_count * sizeof(*ev->listen_read));
+  memset(ev->conn_read, 0, sizeof(ev->conn_read));
+  memset(ev->conn_write, 0, sizeof(ev->conn_write));
+  memset(ev->conn_except, 0, sizeof(ev->conn_except));
+
+#ifdef HAVE_SYS_EPOLL_H
+  if (!epoll_failed && epoll_fd == -1 && !sniff_epoll_init()) {
+    epoll_failed = TRUE;
+  }
+
+  if (epoll_fd != -1) {
+    int ret = sniff_epoll_wait(ev, tv);
+
+    if (ret != -2) {
+      return ret;
+    }
+
+    log_verbose("Cannot update epoll set, using select(): %s",
+                fc_strerror(fc_get_errno()));
+    sniff_epoll_close();
+    epoll_failed = TRUE;
+  }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  return sniff_select(ev, tv);
+}
+
 /* Avoid compiler warning about defined, but unused function
  * by defining it only when needed */
 #if defined(FREECIV_HAVE_LIBREADLINE) || \
@@ -220,6 +561,9 @@ static void close_connection(struct connection *pconn)
   pconn->playing = NULL;
   pconn->client_gui = GUI_STUB;
   pconn->access_level = ALLOW_NONE;
+#ifdef HAVE_SYS_EPOLL_H
+  sniff_epoll_remove_conn(pconn);
+#endif
   connection_common_close(pconn);
 
   send_updated_vote_totals(NULL);
@@ -247,6 +591,11 @@ void close_connections_and_socket(void)
   conn_list_destroy(game.all_connections);
   conn_list_destroy(game.est_connections);
 
+#ifdef HAVE_SYS_EPOLL_H
+  sniff_epoll_close();
+#endif
+  FC_FREE(sniff_events.listen_read);
+
   for (i = 0; i < listen_count; i++) {
     fc_closesocket(listen_socks[i]);
   }
@@ -345,6 +694,83 @@ static void cut_lagging_connection(struct connection *pconn)
   }
 }
 
+/*************************************************************************//**
+  Wait for up to 'tv' for the connections with data to send to become
+  writable. Returns -1 on error, 0 on timeout or if there is nothing to
+  send, and a positive number otherwise.
+*****************************************************************************/
+static int flush_wait(bool *writable, bool *except, fc_timeval *tv)
+{
+  int i, ret;
+#ifdef HAVE_POLL_H
+  /* No limit to the descriptor numbers, unlike with select(). */
+  struct pollfd pfds[MAX_NUM_CONNECTIONS];
+  int ids[MAX_NUM_CONNECTIONS];
+  int npfds = 0;
+
+  for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
+    struct connection *pconn = &connections[i];
+
+    writable[i] = except[i] = FALSE;
+    if (pconn->used
+        && !pconn->server.is_closing
+        && 0 < pconn->send_buffer->ndata) {
+      pfds[npfds].fd = pconn->sock;
+      pfds[npfds].events = POLLOUT | POLLPRI;
+      pfds[npfds].revents = 0;
+      ids[npfds++] = i;
+    }
+  }
+
+  if (npfds == 0) {
+    return 0;
+  }
+
+  ret = poll(pfds, npfds, timeval_to_msec(tv));
+  for (i = 0; i < npfds && ret > 0; i++) {
+    /* Let writing find out about errors and hangups. */
+    writable[ids[i]] = (0 != (pfds[i].revents
+                              & (POLLOUT | POLLERR | POLLHUP)));
+    except[ids[i]] = (0 != (pfds[i].revents & POLLPRI));
+  }
+#else  /* HAVE_POLL_H */
+  int max_desc = -1;
+  fd_set writefs, exceptfs;
+
+  FC_FD_ZERO(&writefs);
+  FC_FD_ZERO(&exceptfs);
+
+  for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
+    struct connection *pconn = &connections[i];
+
+    writable[i] = except[i] = FALSE;
+    if (pconn->used
+        && !pconn->server.is_closing
+        && 0 < pconn->send_buffer->ndata) {
+      FD_SET(pconn->sock, &writefs);
+      FD_SET(pconn->sock, &exceptfs);
+      max_desc = MAX(pconn->sock, max_desc);
+    }
+  }
+
+  if (max_desc == -1) {
+    return 0;
+  }
+
+  ret = fc_select(max_desc + 1, NULL, &writefs, &exceptfs, tv);
+  for (i = 0; i < MAX_NUM_CONNECTIONS && ret > 0; i++) {
+    struct connection *pconn = &connections[i];
+
+    if (pconn->used && !pconn->server.is_closing) {
+      writable[i] = FD_ISSET(pconn->sock, &writefs);
+      except[i] = FD_ISSET(pconn->sock, &exceptfs);
+    }
+  }
+#endif /* HAVE_POLL_H */
+
+  return ret;
+}
+
 /*************************************************************************//**
   Attempt to flush all information in the send buffers for upto 'netwait'
   seconds.
@@ -352,8 +778,7 @@ static void cut_lagging_connection(struct connection *pconn)
 void flush_packets(void)
 {
   int i;
-  int max_desc;
-  fd_set writefs, exceptfs;
+  bool writable[MAX_NUM_CONNECTIONS], except[MAX_NUM_CONNECTIONS];
   fc_timeval tv;
   time_t start;
 
@@ -367,27 +792,7 @@ void flush_packets(void)
       return;
     }
 
-    FC_FD_ZERO(&writefs);
-    FC_FD_ZERO(&exceptfs);
-    max_desc = -1;
-
-    for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
-      struct connection *pconn = &connections[i];
-
-      if (pconn->used
-          && !pconn->server.is_closing
-          && 0 < pconn->send_buffer->ndata) {
-        FD_SET(pconn->sock, &writefs);
-        FD_SET(pconn->sock, &exceptfs);
-        max_desc = MAX(pconn->sock, max_desc);
-      }
-    }
-
-    if (max_desc == -1) {
-      return;
-    }
-
-    if (fc_select(max_desc + 1, NULL, &writefs, &exceptfs, &tv) <= 0) {
+    if (flush_wait(writable, except, &tv) <= 0) {
       return;
     }
 
@@ -395,13 +800,13 @@ void flush_packets(void)
       struct connection *pconn = &connections[i];
 
       if (pconn->used && !pconn->server.is_closing) {
-        if (FD_ISSET(pconn->sock, &exceptfs)) {
+        if (except[i]) {
           log_verbose("connection (%s) cut due to exception data",
                       conn_description(pconn));
           connection_close_server(pconn, _("network exception"));
         } else {
           if (pconn->send_buffer && pconn->send_buffer->ndata > 0) {
-            if (FD_ISSET(pconn->sock, &writefs)) {
+            if (writable[i]) {
               flush_connection_send_buffer_all(pconn);
             } else {
               cut_lagging_connection(pconn);
@@ -494,9 +899,7 @@ static void incoming_client_packets(struct connection *pconn)
 enum server_events server_sniff_all_input(void)
 {
   int i, s;
-  int max_desc;
-  bool excepting;
-  fd_set readfs, writefs, exceptfs;
+  struct sniff_events *ev = &sniff_events;
   fc_timeval tv;
 #ifdef FREECIV_SOCKET_ZERO_NOT_STDIN
   char *bufptr;
@@ -659,42 +1062,9 @@ enum server_events server_sniff_all_input(void)
     tv.tv_sec = 1;
     tv.tv_usec = 0;
 
-    FC_FD_ZERO(&readfs);
-    FC_FD_ZERO(&writefs);
-    FC_FD_ZERO(&exceptfs);
-
-    if (!no_input) {
-#ifdef FREECIV_SOCKET_ZERO_NOT_STDIN
-      fc_init_console();
-#else /* FREECIV_SOCKET_ZERO_NOT_STDIN */
-#   if !defined(__VMS)
-      FD_SET(0, &readfs);
-#   endif /* VMS */
-#endif /* FREECIV_SOCKET_ZERO_NOT_STDIN */
-    }
-
-    max_desc = 0;
-    for (i = 0; i < listen_count; i++) {
-      FD_SET(listen_socks[i], &readfs);
-      FD_SET(listen_socks[i], &exceptfs);
-      max_desc = MAX(max_desc, listen_socks[i]);
-    }
-
-    for (i = 0; i < MAX_NUM_CONNECTIONS; i++) {
-      struct connection *pconn = connections + i;
-
-      if (pconn->used && !pconn->server.is_closing) {
-        FD_SET(pconn->sock, &readfs);
-        if (0 < pconn->send_buffer->ndata) {
-          FD_SET(pconn->sock, &writefs);
-        }
-        FD_SET(pconn->sock, &exceptfs);
-        max_desc = MAX(pconn->sock, max_desc);
-      }
-    }
     con_prompt_off();		/* output doesn't generate a new prompt */
 
-    if (fc_select(max_desc + 1, &readfs, &writefs, &exceptfs, &tv) == 0) {
+    if (sniff_wait(ev, &tv) == 0) {
       /* timeout */
       call_ai_refresh();
       script_server_signal_emit("pulse");
@@ -736,7 +1106,7 @@ enum server_events server_sniff_all_input(void)
 	    lib$stop(status);
 	  }
 	  if (ttchar.numchars) {
-	    FD_SET(0, &readfs);
+	    ev->stdin_read = TRUE;
 	  } else {
 	    continue;
 	  }
@@ -750,19 +1120,12 @@ enum server_events server_sniff_all_input(void)
       }
     }
 
-    excepting = FALSE;
-    for (i = 0; i < listen_count; i++) {
-      if (FD_ISSET(listen_socks[i], &exceptfs)) {
-        excepting = TRUE;
-        break;
-      }
-    }
-    if (excepting) {                  /* handle Ctrl-Z suspend/resume */
+    if (ev->listen_except) {          /* handle Ctrl-Z suspend/resume */
       continue;
     }
     for (i = 0; i < listen_count; i++) {
       s = listen_socks[i];
-      if (FD_ISSET(s, &readfs)) {     /* new players connects */
+      if (ev->listen_read[i]) {       /* new players connects */
         log_verbose("got new connection");
         if (-1 == server_accept_connection(s)) {
           /* There will be a log_error() message from
@@ -779,7 +1142,7 @@ enum server_events server_sniff_all_input(void)
 
       if (pconn->used
           && !pconn->server.is_closing
-          && FD_ISSET(pconn->sock, &exceptfs)) {
+          && ev->conn_except[i]) {
         log_verbose("connection (%s) cut due to exception data",
                     conn_description(pconn));
         connection_close_server(pconn, _("network exception"));
@@ -794,7 +1157,7 @@ enum server_events server_sniff_all_input(void)
       free(bufptr_internal);
     }
 #else  /* !FREECIV_SOCKET_ZERO_NOT_STDIN */
-    if (!no_input && FD_ISSET(0, &readfs)) {    /* input from server operator */
+    if (!no_input && ev->stdin_read) {    /* input from server operator */
 #ifdef FREECIV_HAVE_LIBREADLINE
       rl_callback_read_char();
       if (readline_handled_input) {
@@ -850,7 +1213,7 @@ enum server_events server_sniff_all_input(void)
 
         if (!pconn->used
             || pconn->server.is_closing
-            || !FD_ISSET(pconn->sock, &readfs)) {
+            || !ev->conn_read[i]) {
           continue;
         }
 
@@ -873,7 +1236,7 @@ enum server_events server_sniff_all_input(void)
             && !pconn->server.is_closing
             && pconn->send_buffer
             && pconn->send_buffer->ndata > 0) {
-          if (FD_ISSET(pconn->sock, &writefs)) {
+          if (ev->conn_write[i]) {
             flush_connection_send_buffer_all(pconn);
           } else {
             cut_lagging_connection(pconn);
@@ -1067,6 +1430,10 @@ int server_make_connection(int new_sock, const char *client_addr,
       sz_strlcpy(pconn->addr, client_addr);
       sz_strlcpy(pconn->server.ipaddr, client_ip);
 
+#ifdef HAVE_SYS_EPOLL_H
+      sniff_epoll_add_conn(pconn);
+#endif
+
       conn_list_append(game.all_connections, pconn);
 
       log_verbose("connection (%s) from %s (%s)", 
@@ -1108,9 +1108,7 @@ static void begin_turn(bool is_new_turn)
     /* We build scores at the beginning of every turn.  We have to
      * build them at the beginning so that the AI can use the data,
      * and we are sure to have it when we need it. */
-    players_iterate(pplayer) {
-      calc_civ_score(pplayer);
-    } players_iterate_end;
+    calc_civ_scores();
     log_civ_score_now();
 
     /* Retire useless barbarian units */
@@ -1193,11 +1191,13 @@ static void begin_phase(bool is_new_phase)
   }
 
   /* Must be the first thing as it is needed for lots of functions below! */
+  adv_data_threats_summarize();
   phase_players_iterate(pplayer) {
     /* human players also need this for building advice */
     adv_data_phase_init(pplayer, is_new_phase);
     CALL_PLR_AI_FUNC(phase_begin, pplayer, pplayer, is_new_phase);
   } phase_players_iterate_end;
+  adv_data_threats_forget();
 
   if (is_new_phase) {
     /* Unit "end of turn" activities - of course these actually go at
@@ -2938,9 +2938,7 @@ static void srv_prepare(void)
 static void srv_scores(void)
 {
   /* Recalculate the scores in case of a spaceship victory */
-  players_iterate(pplayer) {
-    calc_civ_score(pplayer);
-  } players_iterate_end;
+  calc_civ_scores();
 
   log_civ_score_now();
 
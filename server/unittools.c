@@ -3124,37 +3124,52 @@ static bool unit_survive_autoattack(struct unit *punit)
   struct autoattack_prob_list *autoattack;
   int moves = punit->moves_left;
   int sanity1 = punit->id;
+  struct tile *unit_ptile = unit_tile(punit);
+  struct city *unit_pcity;
 
   if (!game.server.autoattack) {
     return TRUE;
   }
 
-  autoattack = autoattack_prob_list_new_full(autoattack_prob_free);
+  fc_assert_ret_val(unit_ptile, TRUE);
+  unit_pcity = tile_city(unit_ptile);
+
+  /* Only created once a possible attacker is found. */
+  autoattack = NULL;
 
   /* Kludge to prevent attack power from dropping to zero during calc */
   punit->moves_left = MAX(punit->moves_left, 1);
 
-  adjc_iterate(&(wld.map), unit_tile(punit), ptile) {
+  adjc_iterate(&(wld.map), unit_ptile, ptile) {
     /* First add all eligible units to a autoattack list */
     unit_list_iterate(ptile->units, penemy) {
-      struct autoattack_prob *probability = fc_malloc(sizeof(*probability));
-      struct tile *tgt_tile = unit_tile(punit);
-
-      fc_assert_action(tgt_tile, continue);
-
-      probability->prob =
+      struct act_prob prob =
           action_auto_perf_unit_prob(AAPC_UNIT_MOVED_ADJ,
                                      penemy, unit_owner(punit), NULL,
-                                     tgt_tile, tile_city(tgt_tile),
+                                     unit_ptile, unit_pcity,
                                      punit, NULL);
 
-      if (action_prob_possible(probability->prob)) {
+      /* Only units that can actually attack are stored. */
+      if (action_prob_possible(prob)) {
+        struct autoattack_prob *probability = fc_malloc(sizeof(*probability));
+
+        probability->prob = prob;
         probability->unit_id = penemy->id;
+        if (NULL == autoattack) {
+          autoattack = autoattack_prob_list_new_full(autoattack_prob_free);
+        }
         autoattack_prob_list_prepend(autoattack, probability);
       }
     } unit_list_iterate_end;
   } adjc_iterate_end;
 
+  if (NULL == autoattack) {
+    /* Nobody can attack us here. */
+    punit->moves_left = moves;
+    send_unit_info(NULL, punit);
+    return TRUE;
+  }
+
   /* Sort the potential attackers from highest to lowest success
    * probability. */
   if (autoattack_prob_list_size(autoattack) >= 2) {
@@ -3164,8 +3179,9 @@ static bool unit_survive_autoattack(struct unit *punit)
   autoattack_prob_list_iterate_safe(autoattack, peprob, penemy) {
     int sanity2 = penemy->id;
     struct tile *ptile = unit_tile(penemy);
-    struct unit *enemy_defender = get_defender(punit, ptile);
     double punitwin, penemywin;
+    struct unit *enemy_defender = get_defender_with_chance(punit, ptile,
+                                                           &punitwin);
     double threshold = 0.25;
     struct tile *tgt_tile = unit_tile(punit);
 
@@ -3176,9 +3192,7 @@ static bool unit_survive_autoattack(struct unit *punit)
       threshold = 0.90;
     }
 
-    if (NULL != enemy_defender) {
-      punitwin = unit_win_chance(punit, enemy_defender);
-    } else {
+    if (NULL == enemy_defender) {
       /* 'penemy' can attack 'punit' but it may be not reciproque. */
       punitwin = 1.0;
     }
@@ -3281,13 +3295,20 @@ static void wakeup_neighbor_sentries(struct unit *punit)
   /* There may be sentried units with a sightrange > 3, but we don't
      wake them up if the punit is farther away than 3. */
   square_iterate(&(wld.map), unit_tile(punit), 3, ptile) {
+    int distance_sq = -1;
+
     unit_list_iterate(ptile->units, penemy) {
-      int distance_sq = sq_map_distance(unit_tile(punit), ptile);
-      int radius_sq = get_unit_vision_at(penemy, unit_tile(penemy), V_MAIN);
+      /* Cheap tests first; the vision radius needs an effect lookup. */
+      if (penemy->activity != ACTIVITY_SENTRY
+          || pplayers_allied(unit_owner(punit), unit_owner(penemy))) {
+        continue;
+      }
+      if (0 > distance_sq) {
+        distance_sq = sq_map_distance(unit_tile(punit), ptile);
+      }
 
-      if (!pplayers_allied(unit_owner(punit), unit_owner(penemy))
-          && penemy->activity == ACTIVITY_SENTRY
-          && radius_sq >= distance_sq
+      if (get_unit_vision_at(penemy, unit_tile(penemy), V_MAIN)
+          >= distance_sq
           /* If the unit moved on a city, and the unit is alone, consider
            * it is visible. */
           && (alone_in_city
@@ -213,10 +213,11 @@ static void astr_vadd(struct astring *astr, size_t at,
     buffer = astr_buffer_grow(&buffer_size);
   }
 
-  new_len += at + 1;
-
-  astr_reserve(astr, new_len);
-  fc_strlcpy(astr->str + at, buffer, astr->n_alloc - at);
+  /* The formatted text, including its terminating '\0', is known to fit
+   * after the reservation, so there is nothing for fc_strlcpy() to
+   * truncate. */
+  astr_reserve(astr, at + new_len + 1);
+  memcpy(astr->str + at, buffer, new_len + 1);
 }
 
 /************************************************************************//**
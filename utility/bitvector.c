@@ -183,6 +183,49 @@ void dbv_clr_all(struct dbv *pdbv)
   memset(pdbv->vec, 0, _BV_BYTES(pdbv->bits));
 }
 
+/***********************************************************************//**
+  Return the index of the first set bit at or after 'bit', or -1 if there
+  is none. Clear bytes are skipped as a whole, so iterating over a sparse
+  bitvector with this is much cheaper than testing every bit.
+***************************************************************************/
+int dbv_next_set(const struct dbv *pdbv, int bit)
+{
+  int byte, bytes;
+
+  fc_assert_ret_val(pdbv != NULL, -1);
+  fc_assert_ret_val(pdbv->vec != NULL, -1);
+
+  if (bit < 0) {
+    bit = 0;
+  }
+  if (bit >= pdbv->bits) {
+    return -1;
+  }
+
+  bytes = _BV_BYTES(pdbv->bits);
+  byte = _BV_BYTE_INDEX(bit);
+
+  /* Rest of the first, partially skipped byte. */
+  for (; bit < pdbv->bits && _BV_BYTE_INDEX(bit) == byte; bit++) {
+    if (pdbv->vec[byte] & _BV_BITMASK(bit)) {
+      return bit;
+    }
+  }
+
+  for (byte++; byte < bytes; byte++) {
+    if (pdbv->vec[byte] != 0) {
+      for (bit = byte * 8; bit < pdbv->bits; bit++) {
+        if (pdbv->vec[byte] & _BV_BITMASK(bit)) {
+          return bit;
+        }
+      }
+      return -1;
+    }
+  }
+
+  return -1;
+}
+
 /***********************************************************************//**
   Check if the two dynamic bitvectors are equal.
 ***************************************************************************/
@@ -42,6 +42,7 @@ int dbv_bits(struct dbv *pdbv);
 
 bool dbv_isset(const struct dbv *pdbv, int bit);
 bool dbv_isset_any(const struct dbv *pdbv);
+int dbv_next_set(const struct dbv *pdbv, int bit);
 
 void dbv_set(struct dbv *pdbv, int bit);
 void dbv_set_all(struct dbv *pdbv);
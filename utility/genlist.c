@@ -25,6 +25,11 @@
 
 #include "genlist.h"
 
+/* How many links of removed elements a list keeps for reuse. Enough for
+ * an element or two moving out and back in; the rest are freed so that
+ * a list does not keep the memory of its largest size. */
+#define GENLIST_MAX_SPARE_LINKS 4
+
 /************************************************************************//**
   Create a new empty genlist.
 ****************************************************************************/
@@ -42,15 +47,31 @@ struct genlist *genlist_new_full(genlist_free_fn_t free_data_func)
 
 #ifdef ZERO_VARIABLES_FOR_SEARCHING
   pgenlist->nelements = 0;
+  pgenlist->mutex = NULL;
   pgenlist->head_link = NULL;
   pgenlist->tail_link = NULL;
+  pgenlist->spare_links = NULL;
+  pgenlist->nspare = 0;
 #endif /* ZERO_VARIABLES_FOR_SEARCHING */
-  fc_init_mutex(&pgenlist->mutex);
   pgenlist->free_data_func = free_data_func;
 
   return pgenlist;
 }
 
+/************************************************************************//**
+  Create a new empty genlist that has a mutex, for lists shared between
+  threads. See genlist_allocate_mutex().
+****************************************************************************/
+struct genlist *genlist_new_mutexed(void)
+{
+  struct genlist *pgenlist = genlist_new_full(NULL);
+
+  pgenlist->mutex = fc_malloc(sizeof(*pgenlist->mutex));
+  fc_init_mutex(pgenlist->mutex);
+
+  return pgenlist;
+}
+
 /************************************************************************//**
   Destroys the genlist.
 ****************************************************************************/
@@ -61,7 +82,16 @@ void genlist_destroy(struct genlist *pgenlist)
   }
 
   genlist_clear(pgenlist);
-  fc_destroy_mutex(&pgenlist->mutex);
+  while (NULL != pgenlist->spare_links) {
+    struct genlist_link *plink = pgenlist->spare_links;
+
+    pgenlist->spare_links = plink->next;
+    free(plink);
+  }
+  if (NULL != pgenlist->mutex) {
+    fc_destroy_mutex(pgenlist->mutex);
+    free(pgenlist->mutex);
+  }
   free(pgenlist);
 }
 
@@ -72,7 +102,14 @@ static void genlist_link_new(struct genlist *pgenlist, void *dataptr,
                              struct genlist_link *prev,
                              struct genlist_link *next)
 {
-  struct genlist_link *plink = fc_malloc(sizeof(*plink));
+  struct genlist_link *plink = pgenlist->spare_links;
+
+  if (NULL != plink) {
+    pgenlist->spare_links = plink->next;
+    pgenlist->nspare--;
+  } else {
+    plink = fc_malloc(sizeof(*plink));
+  }
 
   plink->dataptr = dataptr;
   plink->prev = prev;
@@ -90,6 +127,22 @@ static void genlist_link_new(struct genlist *pgenlist, void *dataptr,
   pgenlist->nelements++;
 }
 
+/************************************************************************//**
+  Keep a link which is no longer part of the list for reuse, or free it
+  if there are enough spare links already.
+****************************************************************************/
+static inline void genlist_link_release(struct genlist *pgenlist,
+                                        struct genlist_link *plink)
+{
+  if (pgenlist->nspare < GENLIST_MAX_SPARE_LINKS) {
+    plink->next = pgenlist->spare_links;
+    pgenlist->spare_links = plink;
+    pgenlist->nspare++;
+  } else {
+    free(plink);
+  }
+}
+
 /************************************************************************//**
   Free a link.
 ****************************************************************************/
@@ -115,7 +168,7 @@ static void genlist_link_destroy(struct genlist *pgenlist,
   if (NULL != pgenlist->free_data_func) {
     pgenlist->free_data_func(plink->dataptr);
   }
-  free(plink);
+  genlist_link_release(pgenlist, plink);
 }
 
 /************************************************************************//**
@@ -243,9 +296,9 @@ void *genlist_back(const struct genlist *pgenlist)
 }
 
 /************************************************************************//**
-  Frees all the internal data used by the genlist (but doesn't touch
-  the user-data).  At the end the state of the genlist will be the
-  same as when genlist_init() is called on a new genlist.
+  Removes all the elements of the genlist (but doesn't touch the
+  user-data, unless there is a free data function).  A few links are
+  kept for reuse, see genlist_link_release().
 ****************************************************************************/
 void genlist_clear(struct genlist *pgenlist)
 {
@@ -253,25 +306,23 @@ void genlist_clear(struct genlist *pgenlist)
 
   if (0 < pgenlist->nelements) {
     genlist_free_fn_t free_data_func = pgenlist->free_data_func;
-    struct genlist_link *plink = pgenlist->head_link, *plink2;
+    struct genlist_link *plink = pgenlist->head_link;
 
+    /* NB: detach the links before calling the free function for avoiding
+     * re-entrant code. */
     pgenlist->head_link = NULL;
     pgenlist->tail_link = NULL;
-
     pgenlist->nelements = 0;
 
-    if (NULL != free_data_func) {
-      do {
-        plink2 = plink->next;
+    do {
+      struct genlist_link *plink2 = plink->next;
+
+      if (NULL != free_data_func) {
         free_data_func(plink->dataptr);
-        free(plink);
-      } while (NULL != (plink = plink2));
-    } else {
-      do {
-        plink2 = plink->next;
-        free(plink);
-      } while (NULL != (plink = plink2));
-    }
+      }
+      genlist_link_release(pgenlist, plink);
+      plink = plink2;
+    } while (NULL != plink);
   }
 }
 
@@ -678,11 +729,14 @@ void genlist_reverse(struct genlist *pgenlist)
 }
 
 /************************************************************************//**
-  Allocates list mutex
+  Allocates list mutex. The list must have been created with
+  genlist_new_mutexed().
 ****************************************************************************/
 void genlist_allocate_mutex(struct genlist *pgenlist)
 {
-  fc_allocate_mutex(&pgenlist->mutex);
+  fc_assert_ret(NULL != pgenlist->mutex);
+
+  fc_allocate_mutex(pgenlist->mutex);
 }
 
 /************************************************************************//**
@@ -690,5 +744,7 @@ void genlist_allocate_mutex(struct genlist *pgenlist)
 ****************************************************************************/
 void genlist_release_mutex(struct genlist *pgenlist)
 {
-  fc_release_mutex(&pgenlist->mutex);
+  fc_assert_ret(NULL != pgenlist->mutex);
+
+  fc_release_mutex(pgenlist->mutex);
 }
@@ -55,18 +55,25 @@ typedef bool (*genlist_comp_fn_t) (const void *, const void *);
 
 /* A genlist, storing the number of elements (for quick retrieval and
  * testing for empty lists), and pointers to the first and last elements
- * of the list. */
+ * of the list. A few links of removed elements are kept in 'spare_links'
+ * for reuse, so that a list which has elements removed and added back
+ * (like units of a city changing support) doesn't allocate memory every
+ * time. The mutex exists only for lists created with
+ * genlist_new_mutexed(). */
 struct genlist {
   int nelements;
-  fc_mutex mutex;
+  fc_mutex *mutex;
   struct genlist_link *head_link;
   struct genlist_link *tail_link;
+  struct genlist_link *spare_links;
+  int nspare;
   genlist_free_fn_t free_data_func;
 };
   
 struct genlist *genlist_new(void) fc__warn_unused_result;
 struct genlist *genlist_new_full(genlist_free_fn_t free_data_func)
                 fc__warn_unused_result;
+struct genlist *genlist_new_mutexed(void) fc__warn_unused_result;
 void genlist_destroy(struct genlist *pgenlist);
 
 struct genlist *genlist_copy(const struct genlist *pgenlist)
@@ -248,27 +248,34 @@ static bool is_secfile_entry_name_valid(const char *name)
 }
 
 /**********************************************************************//**
-  Insert an entry into the hash table.  Returns TRUE on success.
+  Insert an entry into the hash table of its section.  Returns TRUE on
+  success.
 **************************************************************************/
 static bool secfile_hash_insert(struct section_file *secfile,
                                 struct entry *pentry)
 {
-  char buf[256];
+  struct section *psection = pentry->psection;
   struct entry *hentry;
 
-  if (NULL == secfile->hash.entries) {
+  if (!secfile->entries_hashed) {
     /* Consider as success if this secfile doesn't have built the entries
      * hash table. */
     return TRUE;
   }
 
-  entry_path(pentry, buf, sizeof(buf));
-  if (entry_hash_replace_full(secfile->hash.entries, buf, pentry,
+  if (NULL == psection->hash) {
+    psection->hash = entry_hash_new();
+  }
+
+  /* The key is the entry name itself, it lives as long as the entry is
+   * in the table. */
+  if (entry_hash_replace_full(psection->hash, pentry->name, pentry,
                               NULL, &hentry)) {
     entry_use(hentry);
     if (!secfile->allow_duplicates) {
-      SECFILE_LOG(secfile, entry_section(hentry),
-                  "Tried to insert same value twice: %s", buf);
+      SECFILE_LOG(secfile, psection,
+                  "Tried to insert same value twice: %s.%s",
+                  psection->name, pentry->name);
       return FALSE;
     }
   }
@@ -277,21 +284,21 @@ static bool secfile_hash_insert(struct section_file *secfile,
 }
 
 /**********************************************************************//**
-  Delete an entry from the hash table.  Returns TRUE on success.
+  Delete an entry from the hash table of its section.  Returns TRUE on
+  success.
 **************************************************************************/
 static bool secfile_hash_delete(struct section_file *secfile,
                                 struct entry *pentry)
 {
-  char buf[256];
+  struct section *psection = pentry->psection;
 
-  if (NULL == secfile->hash.entries) {
+  if (!secfile->entries_hashed || NULL == psection->hash) {
     /* Consider as success if this secfile doesn't have built the entries
      * hash table. */
     return TRUE;
   }
 
-  entry_path(pentry, buf, sizeof(buf));
-  return entry_hash_remove(secfile->hash.entries, buf);
+  return entry_hash_remove(psection->hash, pentry->name);
 }
 
 /**********************************************************************//**
@@ -552,9 +559,11 @@ END:
   if (!error) {
     /* Build the entry hash table. */
     secfile->allow_duplicates = allow_duplicates;
-    secfile->hash.entries = entry_hash_new_nentries(secfile->num_entries);
+    secfile->entries_hashed = TRUE;
 
     section_list_iterate(secfile->sections, hashing_section) {
+      hashing_section->hash =
+          entry_hash_new_nentries(entry_list_size(hashing_section->entries));
       entry_list_iterate(section_entries(hashing_section), pentry) {
         if (!secfile_hash_insert(secfile, pentry)) {
           error = TRUE;
@@ -1723,13 +1732,25 @@ struct entry *secfile_entry_by_path(const struct section_file *secfile,
     fullpath[len - 2] = '\0';
   }
 
-  if (NULL != secfile->hash.entries) {
+  if (secfile->entries_hashed) {
     struct entry *pentry;
 
-    if (entry_hash_lookup(secfile->hash.entries, fullpath, &pentry)) {
-      entry_use(pentry);
+    /* Section names may contain dots, so try every split point, the
+     * first one being by far the most common. */
+    for (ent_name = strchr(fullpath, '.'); NULL != ent_name;
+         ent_name = strchr(ent_name + 1, '.')) {
+      *ent_name = '\0';
+      psection = secfile_section_by_name(secfile, fullpath);
+      *ent_name = '.';
+      if (NULL != psection) {
+        if (NULL != psection->hash
+            && entry_hash_lookup(psection->hash, ent_name + 1, &pentry)) {
+          entry_use(pentry);
+          return pentry;
+        }
+      }
     }
-    return pentry;
+    return NULL;
   }
 
   /* I dont like strtok.
@@ -2745,11 +2766,18 @@ int *secfile_lookup_enum_vec_data(const struct section_file *secfile,
 struct section *secfile_section_by_name(const struct section_file *secfile,
                                         const char *name)
 {
+  struct section *psection;
+
   SECFILE_RETURN_VAL_IF_FAIL(secfile, NULL, NULL != secfile, NULL);
 
-  section_list_iterate(secfile->sections, psection) {
-    if (0 == strcmp(section_name(psection), name)) {
-      return psection;
+  if (NULL != secfile->hash.sections) {
+    return (section_hash_lookup(secfile->hash.sections, name, &psection)
+            ? psection : NULL);
+  }
+
+  section_list_iterate(secfile->sections, psection2) {
+    if (0 == strcmp(section_name(psection2), name)) {
+      return psection2;
     }
   } section_list_iterate_end;
 
@@ -2848,6 +2876,7 @@ struct section *secfile_section_new(struct section_file *secfile,
   psection->special = EST_NORMAL;
   psection->name = fc_strdup(name);
   psection->entries = entry_list_new_full(entry_destroy);
+  psection->hash = NULL;
 
   /* Append to secfile. */
   psection->secfile = secfile;
@@ -2883,6 +2912,9 @@ void section_destroy(struct section *psection)
   }
 
   entry_list_destroy(psection->entries);
+  if (NULL != psection->hash) {
+    entry_hash_destroy(psection->hash);
+  }
   free(psection->name);
   free(psection);
 }
@@ -2940,11 +2972,6 @@ bool section_set_name(struct section *psection, const char *name)
   if (NULL != secfile->hash.sections) {
     section_hash_remove(secfile->hash.sections, psection->name);
   }
-  if (NULL != secfile->hash.entries) {
-    entry_list_iterate(psection->entries, pentry) {
-      secfile_hash_delete(secfile, pentry);
-    } entry_list_iterate_end;
-  }
 
   /* Really rename. */
   free(psection->name);
@@ -2954,11 +2981,6 @@ bool section_set_name(struct section *psection, const char *name)
   if (NULL != secfile->hash.sections) {
     section_hash_insert(secfile->hash.sections, psection->name, psection);
   }
-  if (NULL != secfile->hash.entries) {
-    entry_list_iterate(psection->entries, pentry) {
-      secfile_hash_insert(secfile, pentry);
-    } entry_list_iterate_end;
-  }
 
   return TRUE;
 }
@@ -2980,6 +3002,19 @@ struct entry *section_entry_by_name(const struct section *psection,
 {
   SECFILE_RETURN_VAL_IF_FAIL(NULL, psection, NULL != psection, NULL);
 
+  if (NULL != psection->hash && NULL != psection->secfile
+      && psection->secfile->entries_hashed
+      && !psection->secfile->allow_duplicates) {
+    /* Names are unique, the hash table holds them all. */
+    struct entry *pentry;
+
+    if (entry_hash_lookup(psection->hash, name, &pentry)) {
+      entry_use(pentry);
+      return pentry;
+    }
+    return NULL;
+  }
+
   entry_list_iterate(psection->entries, pentry) {
     if (0 == strcmp(entry_name(pentry), name)) {
       entry_use(pentry);
@@ -83,8 +83,8 @@ struct section_file *secfile_new(bool allow_duplicates)
   secfile->allow_digital_boolean = FALSE; /* Default */
 
   secfile->hash.sections = section_hash_new();
-  /* Maybe allocated later. */
-  secfile->hash.entries = NULL;
+  /* Maybe enabled later. */
+  secfile->entries_hashed = FALSE;
 
   return secfile;
 }
@@ -100,12 +100,8 @@ void secfile_destroy(struct section_file *secfile)
   /* Mark it NULL to be sure to don't try to make operations when
    * deleting the entries. */
   secfile->hash.sections = NULL;
-  if (NULL != secfile->hash.entries) {
-    entry_hash_destroy(secfile->hash.entries);
-    /* Mark it NULL to be sure to don't try to make operations when
-     * deleting the entries. */
-    secfile->hash.entries = NULL;
-  }
+  /* The section entry hash tables are freed with the sections. */
+  secfile->entries_hashed = FALSE;
 
   section_list_destroy(secfile->sections);
 
@@ -30,6 +30,7 @@ struct section {
   enum entry_special_type special;
   char *name;                   /* Name of the section. */
   struct entry_list *entries;   /* The list of the children. */
+  struct entry_hash *hash;      /* Children by name, maybe NULL. */
 };
 
 /* The section file struct itself. */
@@ -44,9 +45,9 @@ struct section_file {
   struct section_list *sections;
   bool allow_duplicates;
   bool allow_digital_boolean;
+  bool entries_hashed;          /* Whether sections hash their entries. */
   struct {
     struct section_hash *sections;
-    struct entry_hash *entries;
   } hash;
 };
 
@@ -76,7 +77,7 @@ void secfile_log(const struct section_file *secfile,
 #include "spechash.h"
 
 #define SPECHASH_TAG entry
-#define SPECHASH_ASTR_KEY_TYPE
+#define SPECHASH_CSTR_KEY_TYPE
 #define SPECHASH_IDATA_TYPE struct entry *
 #include "spechash.h"
 
@@ -40,6 +40,7 @@
  * and prototypes for the following functions:
  *    struct foo_list *foo_list_new(void);
  *    struct foo_list *foo_list_new_full(foo_list_free_fn_t free_data_func);
+ *    struct foo_list *foo_list_new_mutexed(void);
  *    void foo_list_destroy(struct foo_list *plist);
  *    struct foo_list *foo_list_copy(const struct foolist *plist);
  *    struct foo_list *foo_list_copy_full(const struct foolist *plist,
@@ -170,6 +171,17 @@ static inline SPECLIST_LIST *SPECLIST_FOO(_list_new) (void)
   return (SPECLIST_LIST *) genlist_new();
 }
 
+/****************************************************************************
+  Create a new speclist with a mutex, see SPECLIST_FOO(_list_allocate_mutex).
+****************************************************************************/
+static inline SPECLIST_LIST *SPECLIST_FOO(_list_new_mutexed) (void)
+fc__warn_unused_result;
+
+static inline SPECLIST_LIST *SPECLIST_FOO(_list_new_mutexed) (void)
+{
+  return (SPECLIST_LIST *) genlist_new_mutexed();
+}
+
 /****************************************************************************
   Create a new speclist with a free callback.
 ****************************************************************************/